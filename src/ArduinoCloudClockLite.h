@@ -0,0 +1,42 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_CLOCK_LITE_H_
+#define ARDUINO_CLOUD_CLOCK_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
+
+typedef unsigned long(*CloudClockFunc)(void);
+
+/******************************************************************************
+   FUNCTION DECLARATION
+ ******************************************************************************/
+
+/* Time source of the update policies and of the Thing scheduling, in milliseconds. It is millis() unless replaced,
+   e.g. by a simulated clock on a host build or by a clock that keeps running while the MCU sleeps. NULL restores millis() */
+void setCloudClock(CloudClockFunc clock);
+unsigned long cloudMillis();
+
+#endif /* ARDUINO_CLOUD_CLOCK_LITE_H_ */
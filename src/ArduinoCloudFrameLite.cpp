@@ -0,0 +1,523 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "ArduinoCloudFrameLite.h"
+#include "ArduinoCloudPropertyLite.h"
+
+/******************************************************************************
+   LOCAL FUNCTIONS
+ ******************************************************************************/
+
+static void encodeUInt32(uint32_t const value, uint8_t * bytes) {
+  bytes[0] = value & 0xFF;
+  bytes[1] = (value >> 8) & 0xFF;
+  bytes[2] = (value >> 16) & 0xFF;
+  bytes[3] = (value >> 24) & 0xFF;
+}
+
+static uint32_t decodeUInt32(uint8_t const * bytes) {
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint8_t const TIMESTAMP_FLAG = 0x80;
+
+/* Room reserved in the response for each queried string, longer strings that do not fit are read on their own */
+static size_t const QUERY_STRING_RESERVE = 32;
+
+/* Length of the value starting at value, 0 if it exceeds end */
+static size_t valueLength(uint8_t const type, uint8_t const * value, uint8_t const * end) {
+  switch (static_cast<Type>(type)) {
+    case Type::Bool:   return 1;
+    case Type::Int:    return 4;
+    case Type::Float:  return 4;
+    case Type::String: return (value < end) ? (1 + value[0]) : 0;
+    default:           return 0;
+  }
+}
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+ArduinoCloudFrameLite::ArduinoCloudFrameLite() :
+  _transport(nullptr),
+  _mode(Mode::Write),
+  _light_payload(false),
+  _length(0),
+  _cursor(0),
+  _response_length(0),
+  _overflow(false),
+  _checkpoint_length(0),
+  _checkpoint_response_length(0),
+  _checkpoint_count(0),
+  _group_offset(0),
+  _group_count(0),
+  _flushes(0) {
+  reset();
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudFrameLite::beginWrite(ArduinoCloudTransportLite * transport) {
+  _transport = transport;
+  _mode = Mode::Write;
+  _group_offset = 0;
+  reset();
+}
+
+void ArduinoCloudFrameLite::end() {
+  flush();
+}
+
+void ArduinoCloudFrameLite::beginQuery(ArduinoCloudTransportLite & transport) {
+  _transport = &transport;
+  _mode = Mode::Query;
+  reset();
+}
+
+void ArduinoCloudFrameLite::beginResponse(ArduinoCloudTransportLite * transport, size_t const length) {
+  _transport = transport;
+  _mode = Mode::Response;
+  _length = (length > ARDUINO_CLOUD_FRAME_LITE_SIZE) ? ARDUINO_CLOUD_FRAME_LITE_SIZE : length;
+  if (_length == 0) {
+    reset();
+  }
+  _cursor = 1;
+}
+
+void ArduinoCloudFrameLite::iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp) {
+  if (_mode == Mode::Query) {
+    appendQuery(name, identifier, Type::Bool);
+  } else if (!read(name, identifier, value, &timestamp) && _transport != nullptr) {
+    _transport->iotReadPropertyBool(name, identifier, value, timestamp);
+  }
+}
+
+void ArduinoCloudFrameLite::iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp) {
+  if (_mode == Mode::Query) {
+    appendQuery(name, identifier, Type::Int);
+  } else if (!read(name, identifier, value, &timestamp) && _transport != nullptr) {
+    _transport->iotReadPropertyInt(name, identifier, value, timestamp);
+  }
+}
+
+void ArduinoCloudFrameLite::iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp) {
+  if (_mode == Mode::Query) {
+    appendQuery(name, identifier, Type::Float);
+  } else if (!read(name, identifier, value, &timestamp) && _transport != nullptr) {
+    _transport->iotReadPropertyFloat(name, identifier, value, timestamp);
+  }
+}
+
+void ArduinoCloudFrameLite::iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp) {
+  if (_mode == Mode::Query) {
+    appendQuery(name, identifier, Type::String);
+  } else if (!read(name, identifier, value, &timestamp) && _transport != nullptr) {
+    _transport->iotReadPropertyString(name, identifier, value, timestamp);
+  }
+}
+
+void ArduinoCloudFrameLite::iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value) {
+  if ((_mode != Mode::Write || !append(name, identifier, value)) && _transport != nullptr) {
+    _transport->iotWritePropertyBool(name, identifier, value);
+  }
+}
+
+void ArduinoCloudFrameLite::iotWritePropertyInt(char const * name, uint16_t const identifier, int const value) {
+  if ((_mode != Mode::Write || !append(name, identifier, value)) && _transport != nullptr) {
+    _transport->iotWritePropertyInt(name, identifier, value);
+  }
+}
+
+void ArduinoCloudFrameLite::iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value) {
+  if ((_mode != Mode::Write || !append(name, identifier, value)) && _transport != nullptr) {
+    _transport->iotWritePropertyFloat(name, identifier, value);
+  }
+}
+
+void ArduinoCloudFrameLite::iotWritePropertyString(char const * name, uint16_t const identifier, String const & value) {
+  if ((_mode != Mode::Write || !append(name, identifier, value)) && _transport != nullptr) {
+    _transport->iotWritePropertyString(name, identifier, value);
+  }
+}
+
+void ArduinoCloudFrameLite::iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp) {
+  if (_mode == Mode::Query) {
+    appendQuery(name, identifier, Type::String);
+    return;
+  }
+  uint8_t const * bytes = findEntry(name, identifier, Type::String, &timestamp);
+  if (bytes != NULL) {
+    size_t const length = (bytes[0] > (size - 2)) ? (size - 2) : bytes[0];
+    value[0] = length;
+    memcpy(&value[1], &bytes[1], length);
+    value[1 + length] = '\0';
+  } else if (_transport != nullptr) {
+    _transport->iotReadPropertyChars(name, identifier, value, size, timestamp);
+  }
+}
+
+void ArduinoCloudFrameLite::iotWritePropertyChars(char const * name, uint16_t const identifier, uint8_t const * value) {
+  if ((_mode != Mode::Write || !appendEntry(name, identifier, static_cast<uint8_t>(Type::String), &value[1], value[0], true)) && _transport != nullptr) {
+    _transport->iotWritePropertyChars(name, identifier, value);
+  }
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, bool const value) {
+  uint8_t const bytes = value ? 1 : 0;
+  return appendEntry(name, identifier, static_cast<uint8_t>(Type::Bool), &bytes, 1, false);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, int const value) {
+  uint8_t bytes[4];
+  encodeUInt32(static_cast<uint32_t>(static_cast<int32_t>(value)), bytes);
+  return appendEntry(name, identifier, static_cast<uint8_t>(Type::Int), bytes, sizeof(bytes), false);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, float const value) {
+  uint32_t raw;
+  memcpy(&raw, &value, sizeof(raw));
+  uint8_t bytes[4];
+  encodeUInt32(raw, bytes);
+  return appendEntry(name, identifier, static_cast<uint8_t>(Type::Float), bytes, sizeof(bytes), false);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, String const & value) {
+  return appendEntry(name, identifier, static_cast<uint8_t>(Type::String), reinterpret_cast<uint8_t const *>(value.c_str()), value.length(), true);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp) {
+  uint8_t const bytes = value ? 1 : 0;
+  return appendTimestamp(appendEntry(name, identifier, static_cast<uint8_t>(Type::Bool), &bytes, 1, false, true), timestamp);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp) {
+  uint8_t bytes[4];
+  encodeUInt32(static_cast<uint32_t>(static_cast<int32_t>(value)), bytes);
+  return appendTimestamp(appendEntry(name, identifier, static_cast<uint8_t>(Type::Int), bytes, sizeof(bytes), false, true), timestamp);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp) {
+  uint32_t raw;
+  memcpy(&raw, &value, sizeof(raw));
+  uint8_t bytes[4];
+  encodeUInt32(raw, bytes);
+  return appendTimestamp(appendEntry(name, identifier, static_cast<uint8_t>(Type::Float), bytes, sizeof(bytes), false, true), timestamp);
+}
+
+bool ArduinoCloudFrameLite::append(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp) {
+  return appendTimestamp(appendEntry(name, identifier, static_cast<uint8_t>(Type::String), reinterpret_cast<uint8_t const *>(value.c_str()), value.length(), true, true), timestamp);
+}
+
+bool ArduinoCloudFrameLite::appendChars(char const * name, uint16_t const identifier, uint8_t const * value, unsigned long const timestamp) {
+  return appendTimestamp(appendEntry(name, identifier, static_cast<uint8_t>(Type::String), &value[1], value[0], true, true), timestamp);
+}
+
+bool ArduinoCloudFrameLite::appendEncoded(uint8_t const * entry, size_t const length) {
+  if (_mode != Mode::Write || !hasRoomFor(length)) {
+    return false;
+  }
+  memcpy(&_buffer[_length], entry, length);
+  _length += length;
+  _buffer[0]++;
+  return true;
+}
+
+void ArduinoCloudFrameLite::remove(size_t const offset, size_t const length) {
+  if (_mode != Mode::Write || count() == 0 || offset < 1 || (offset + length) > _length) {
+    return;
+  }
+  memmove(&_buffer[offset], &_buffer[offset + length], _length - offset - length);
+  _length -= length;
+  _buffer[0]--;
+}
+
+void ArduinoCloudFrameLite::beginGroup() {
+  _group_offset = _length;
+  _group_count = count();
+}
+
+void ArduinoCloudFrameLite::endGroup() {
+  _group_offset = 0;
+}
+
+bool ArduinoCloudFrameLite::appendQuery(char const * name, uint16_t const identifier, Type const type) {
+  size_t const value_length = (type == Type::String) ? (1 + QUERY_STRING_RESERVE) : ((type == Type::Bool) ? 1 : 4);
+  size_t const response_length = 1 + keyLength(name) + value_length + 4;
+  if (_mode != Mode::Query || (_response_length + response_length) > ARDUINO_CLOUD_FRAME_LITE_SIZE ||
+      !appendEntry(name, identifier, static_cast<uint8_t>(type), NULL, 0, false)) {
+    _overflow = true;
+    return false;
+  }
+  _response_length += response_length;
+  return true;
+}
+
+void ArduinoCloudFrameLite::checkpoint() {
+  _checkpoint_length = _length;
+  _checkpoint_response_length = _response_length;
+  _checkpoint_count = count();
+}
+
+void ArduinoCloudFrameLite::rollback() {
+  _length = _checkpoint_length;
+  _response_length = _checkpoint_response_length;
+  _buffer[0] = _checkpoint_count;
+  _overflow = false;
+}
+
+bool ArduinoCloudFrameLite::read(char const * name, uint16_t const identifier, bool & value, unsigned long * timestamp) {
+  uint8_t const * bytes = findEntry(name, identifier, Type::Bool, timestamp);
+  if (bytes == NULL) {
+    return false;
+  }
+  decodeValue(bytes, value);
+  return true;
+}
+
+bool ArduinoCloudFrameLite::read(char const * name, uint16_t const identifier, int & value, unsigned long * timestamp) {
+  uint8_t const * bytes = findEntry(name, identifier, Type::Int, timestamp);
+  if (bytes == NULL) {
+    return false;
+  }
+  decodeValue(bytes, value);
+  return true;
+}
+
+bool ArduinoCloudFrameLite::read(char const * name, uint16_t const identifier, float & value, unsigned long * timestamp) {
+  uint8_t const * bytes = findEntry(name, identifier, Type::Float, timestamp);
+  if (bytes == NULL) {
+    return false;
+  }
+  decodeValue(bytes, value);
+  return true;
+}
+
+bool ArduinoCloudFrameLite::read(char const * name, uint16_t const identifier, String & value, unsigned long * timestamp) {
+  uint8_t const * bytes = findEntry(name, identifier, Type::String, timestamp);
+  if (bytes == NULL) {
+    return false;
+  }
+  decodeValue(bytes, value);
+  return true;
+}
+
+bool ArduinoCloudFrameLite::parseEntry(uint8_t const * data, size_t const length, size_t & offset, Mode const mode, Entry & entry) {
+  if (offset < 1 || (offset + 3) > length) {
+    return false;
+  }
+  uint8_t const * end = data + length;
+  uint8_t const * p = data + offset;
+  bool const timestamped = (mode == Mode::Response) || (p[0] & TIMESTAMP_FLAG);
+  entry.key = static_cast<Key>((p[0] >> 4) & 0x07);
+  entry.type = static_cast<Type>(p[0] & 0x0F);
+  if (entry.key == Key::Identifier) {
+    entry.name = NULL;
+    entry.name_length = 0;
+    entry.identifier = p[1] | (p[2] << 8);
+    p += 3;
+  } else {
+    entry.name = reinterpret_cast<char const *>(&p[2]);
+    entry.name_length = p[1];
+    entry.identifier = 0;
+    p += 2 + p[1];
+  }
+  if (p > end) {
+    return false;
+  }
+  entry.value = NULL;
+  entry.timestamp = 0;
+  if (mode != Mode::Query) {
+    size_t const value_length = valueLength(static_cast<uint8_t>(entry.type), p, end);
+    if (value_length == 0 || (p + value_length) > end) {
+      return false;
+    }
+    entry.value = p;
+    p += value_length;
+  }
+  if (timestamped) {
+    if ((p + 4) > end) {
+      return false;
+    }
+    entry.timestamp = decodeUInt32(p);
+    p += 4;
+  }
+  offset = p - data;
+  return true;
+}
+
+void ArduinoCloudFrameLite::decodeValue(uint8_t const * bytes, bool & value) {
+  value = (bytes[0] != 0);
+}
+
+void ArduinoCloudFrameLite::decodeValue(uint8_t const * bytes, int & value) {
+  value = static_cast<int>(static_cast<int32_t>(decodeUInt32(bytes)));
+}
+
+void ArduinoCloudFrameLite::decodeValue(uint8_t const * bytes, float & value) {
+  uint32_t const raw = decodeUInt32(bytes);
+  memcpy(&value, &raw, sizeof(value));
+}
+
+void ArduinoCloudFrameLite::decodeValue(uint8_t const * bytes, String & value) {
+  value = "";
+  value.reserve(bytes[0]);
+  for (uint8_t i = 0; i < bytes[0]; i++) {
+    value += static_cast<char>(bytes[1 + i]);
+  }
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudFrameLite::reset() {
+  _buffer[0] = 0;
+  _length = 1;
+  /* An open group goes on from the start of the frame */
+  if (_group_offset != 0) {
+    _group_offset = 1;
+    _group_count = 0;
+  }
+  _response_length = 1;
+  _overflow = false;
+}
+
+void ArduinoCloudFrameLite::flush() {
+  if (count() > 0 && _transport != nullptr) {
+    _transport->iotWriteProperties(_buffer, _length);
+    _flushes++;
+  }
+  reset();
+}
+
+/* Passes the entries preceding the open group to the transport and moves the group to the start of the frame */
+void ArduinoCloudFrameLite::flushBeforeGroup() {
+  uint8_t const group_entries = count() - _group_count;
+  size_t const group_length = _length - _group_offset;
+  _buffer[0] = _group_count;
+  _transport->iotWriteProperties(_buffer, _group_offset);
+  _flushes++;
+  memmove(&_buffer[1], &_buffer[_group_offset], group_length);
+  _buffer[0] = group_entries;
+  _length = 1 + group_length;
+  _group_offset = 1;
+  _group_count = 0;
+}
+
+size_t ArduinoCloudFrameLite::keyLength(char const * name) const {
+  return _light_payload ? 2 : (1 + strlen(name));
+}
+
+/* If timestamped, room for the timestamp is reserved after the value, for appendTimestamp() to fill */
+bool ArduinoCloudFrameLite::appendEntry(char const * name, uint16_t const identifier, uint8_t const type, uint8_t const * value, size_t const value_length, bool const value_length_prefix, bool const timestamped) {
+  size_t const key_length = keyLength(name);
+  size_t const entry_length = 1 + key_length + (value_length_prefix ? 1 : 0) + value_length + (timestamped ? 4 : 0);
+  if (key_length > 256 || value_length > 255 || !hasRoomFor(entry_length)) {
+    return false;
+  }
+
+  uint8_t const flags = timestamped ? TIMESTAMP_FLAG : 0;
+  if (_light_payload) {
+    _buffer[_length++] = flags | (static_cast<uint8_t>(Key::Identifier) << 4) | type;
+    _buffer[_length++] = identifier & 0xFF;
+    _buffer[_length++] = (identifier >> 8) & 0xFF;
+  } else {
+    _buffer[_length++] = flags | (static_cast<uint8_t>(Key::Name) << 4) | type;
+    _buffer[_length++] = key_length - 1;
+    memcpy(&_buffer[_length], name, key_length - 1);
+    _length += key_length - 1;
+  }
+  if (value_length_prefix) {
+    _buffer[_length++] = value_length;
+  }
+  if (value_length > 0) {
+    memcpy(&_buffer[_length], value, value_length);
+    _length += value_length;
+  }
+  _buffer[0]++;
+  return true;
+}
+
+/* Makes room for entry_length more bytes, flushing the frame if needed and possible */
+bool ArduinoCloudFrameLite::hasRoomFor(size_t const entry_length) {
+  if ((1 + entry_length) > ARDUINO_CLOUD_FRAME_LITE_SIZE) {
+    return false;
+  }
+  if ((_length + entry_length) > ARDUINO_CLOUD_FRAME_LITE_SIZE || count() == 255) {
+    if (_mode != Mode::Write || _transport == nullptr) {
+      return false;
+    }
+    if (_group_offset > 1 && (1 + (_length - _group_offset) + entry_length) <= ARDUINO_CLOUD_FRAME_LITE_SIZE) {
+      flushBeforeGroup();
+    } else {
+      flush();
+    }
+  }
+  return true;
+}
+
+bool ArduinoCloudFrameLite::appendTimestamp(bool const appended, unsigned long const timestamp) {
+  if (appended) {
+    encodeUInt32(timestamp, &_buffer[_length]);
+    _length += 4;
+  }
+  return appended;
+}
+
+/* Entries are normally read back in the order they were queried, so the entry at the cursor is tried first */
+uint8_t const * ArduinoCloudFrameLite::findEntry(char const * name, uint16_t const identifier, Type const type, unsigned long * timestamp) {
+  if (_mode != Mode::Response) {
+    return NULL;
+  }
+  size_t const name_length = _light_payload ? 0 : strlen(name);
+  size_t offset = _cursor;
+  Entry entry;
+  for (uint8_t i = 0; i < count(); i++) {
+    if (!parseEntry(_buffer, _length, offset, Mode::Response, entry)) {
+      // end of the frame, or truncated or malformed entry: restart from the first one
+      offset = 1;
+      if (!parseEntry(_buffer, _length, offset, Mode::Response, entry)) {
+        return NULL;
+      }
+    }
+    bool match = false;
+    if (entry.type == type) {
+      if (entry.key == Key::Identifier) {
+        match = _light_payload && entry.identifier == identifier;
+      } else {
+        match = !_light_payload && entry.name_length == name_length && memcmp(entry.name, name, name_length) == 0;
+      }
+    }
+    if (match) {
+      if (timestamp != NULL) {
+        *timestamp = entry.timestamp;
+      }
+      _cursor = offset;
+      return entry.value;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,221 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_FRAME_LITE_H_
+#define ARDUINO_CLOUD_FRAME_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#include "ArduinoCloudTransportLite.h"
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
+
+enum class Type;
+
+/******************************************************************************
+   CONSTANTS
+ ******************************************************************************/
+
+/* Size of the buffer holding a frame. Can be overridden from the build flags */
+#ifndef ARDUINO_CLOUD_FRAME_LITE_SIZE
+  #define ARDUINO_CLOUD_FRAME_LITE_SIZE 256
+#endif
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Packs several property values into a single buffer so that they can be handed to the transport in one call.
+
+   frame := count:uint8 entry*
+   entry := tag:uint8 key value [timestamp:uint32]
+   tag   := timestamp flag (0x80) | (key kind << 4) | value type, the value type being a Type
+   key   := Name: name length:uint8 name chars | Identifier: uint16
+   value := Bool: uint8 | Int: int32 | Float: IEEE 754 binary32 | String: length:uint8 chars
+
+   Multi-byte values are little endian. With the light payload, entries are keyed by the property identifier,
+   the upper byte addressing the attribute of composite properties, instead of by name.
+   A frame is used in one of three modes:
+   - Write: entries carry the values to be sent. When the buffer is full the pending entries are passed
+     to the transport and the frame starts over, so it never needs to fit all the properties of a Thing.
+     Without a transport the frame is a bounded store instead, appends fail once it is full.
+     Entries carrying the local change timestamp of the value have the timestamp flag set.
+   - Query: entries carry no value, they list the properties whose cloud value is requested.
+   - Response: the answer to a query, each entry is followed by the last cloud change timestamp
+     of the property, whether the timestamp flag is set or not. Values are read back by key.
+
+   The frame is itself a transport wrapping the one it has been begun with: properties read and write through it
+   as they would through the wrapped transport, and whatever the current mode can not handle is forwarded to it. */
+class ArduinoCloudFrameLite : public ArduinoCloudTransportLite {
+  public:
+    enum class Key : uint8_t {
+      Name = 0, Identifier = 1
+    };
+
+    enum class Mode : uint8_t {
+      Write, Query, Response
+    };
+
+    /* A decoded entry, name is not '\0' terminated. value is NULL for query entries, timestamp is 0 if the entry carries none */
+    struct Entry {
+      Key             key;
+      Type            type;
+      char const *    name;
+      uint8_t         name_length;
+      uint16_t        identifier;
+      uint8_t const * value;
+      unsigned long   timestamp;
+    };
+
+    ArduinoCloudFrameLite();
+
+    void beginWrite(ArduinoCloudTransportLite * transport);
+    /* Flushes the pending entries, if any */
+    void end();
+    void beginQuery(ArduinoCloudTransportLite & transport);
+    /* Starts reading the length bytes received in the buffer returned by responseBuffer(). Values missing from the
+       response are read from transport if not NULL. A transport answering a query builds its response with
+       beginResponse(NULL, 0) and the timestamped append() */
+    void beginResponse(ArduinoCloudTransportLite * transport, size_t const length);
+
+    inline Mode mode() const {
+      return _mode;
+    }
+    inline void setLightPayload(bool const lightPayload) {
+      _light_payload = lightPayload;
+    }
+    inline bool lightPayload() const {
+      return _light_payload;
+    }
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp);
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp);
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp);
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp);
+
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value);
+
+    /* Encoded and decoded in place, without going through a String */
+    virtual void iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp);
+    virtual void iotWritePropertyChars(char const * name, uint16_t const identifier, uint8_t const * value);
+
+    /* Write mode: returns false if the entry can not fit an empty frame, in which case the caller has to send it on its own,
+       or if a frame without transport is full */
+    bool append(char const * name, uint16_t const identifier, bool const value);
+    bool append(char const * name, uint16_t const identifier, int const value);
+    bool append(char const * name, uint16_t const identifier, float const value);
+    bool append(char const * name, uint16_t const identifier, String const & value);
+    /* Write and Response modes: appends an entry followed by timestamp */
+    bool append(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp);
+    bool append(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp);
+    bool append(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp);
+    bool append(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp);
+    /* Same as above for a string held as in ArduinoCloudTransportLite::iotReadPropertyChars() */
+    bool appendChars(char const * name, uint16_t const identifier, uint8_t const * value, unsigned long const timestamp);
+    /* Write mode: appends an entry encoded by another frame */
+    bool appendEncoded(uint8_t const * entry, size_t const length);
+    /* Write mode: removes the length bytes long entry starting at offset */
+    void remove(size_t const offset, size_t const length);
+    /* Write mode: the entries appended between beginGroup() and endGroup(), typically the attributes of a composite property,
+       are passed to the transport in the same call. When they do not fit the rest of the frame, the entries preceding the group
+       are flushed on their own. Only a group which does not fit an empty frame is split */
+    void beginGroup();
+    void endGroup();
+    /* Write mode: number of times the entries have been passed to the transport, wraps around */
+    inline uint8_t flushes() const {
+      return _flushes;
+    }
+
+    /* Query mode: returns false if the frame, or the response expected for it, would not fit the buffer.
+       overflowed() then reports it until the next rollback() */
+    bool appendQuery(char const * name, uint16_t const identifier, Type const type);
+    inline bool overflowed() const {
+      return _overflow;
+    }
+    /* Query mode: rollback() drops the entries appended after the last checkpoint() */
+    void checkpoint();
+    void rollback();
+
+    /* Response mode: returns false if the frame holds no entry for the key with the requested type */
+    bool read(char const * name, uint16_t const identifier, bool & value, unsigned long * timestamp);
+    bool read(char const * name, uint16_t const identifier, int & value, unsigned long * timestamp);
+    bool read(char const * name, uint16_t const identifier, float & value, unsigned long * timestamp);
+    bool read(char const * name, uint16_t const identifier, String & value, unsigned long * timestamp);
+
+    /* Decodes the entry starting at offset in a frame of the given mode and moves offset past it.
+       Returns false at the end of the frame or if the entry is malformed. Offset 1 is the first entry */
+    static bool parseEntry(uint8_t const * data, size_t const length, size_t & offset, Mode const mode, Entry & entry);
+    static void decodeValue(uint8_t const * bytes, bool & value);
+    static void decodeValue(uint8_t const * bytes, int & value);
+    static void decodeValue(uint8_t const * bytes, float & value);
+    static void decodeValue(uint8_t const * bytes, String & value);
+
+    inline uint8_t const * data() const {
+      return _buffer;
+    }
+    inline size_t length() const {
+      return _length;
+    }
+    inline uint8_t count() const {
+      return _buffer[0];
+    }
+    inline uint8_t * responseBuffer() {
+      return _buffer;
+    }
+    inline size_t capacity() const {
+      return ARDUINO_CLOUD_FRAME_LITE_SIZE;
+    }
+
+  private:
+    ArduinoCloudTransportLite * _transport;
+    Mode      _mode;
+    bool      _light_payload;
+    size_t    _length;
+    /* Response mode: offset of the entry following the last one read */
+    size_t    _cursor;
+    /* Query mode: expected length of the response */
+    size_t    _response_length;
+    bool      _overflow;
+    size_t    _checkpoint_length,
+              _checkpoint_response_length;
+    uint8_t   _checkpoint_count;
+    /* Write mode: offset and count of the entries preceding the open group, offset 0 if no group is open */
+    size_t    _group_offset;
+    uint8_t   _group_count;
+    uint8_t   _flushes;
+    uint8_t   _buffer[ARDUINO_CLOUD_FRAME_LITE_SIZE];
+
+    void reset();
+    void flush();
+    void flushBeforeGroup();
+    size_t keyLength(char const * name) const;
+    bool appendEntry(char const * name, uint16_t const identifier, uint8_t const type, uint8_t const * value, size_t const value_length, bool const value_length_prefix, bool const timestamped = false);
+    bool appendTimestamp(bool const appended, unsigned long const timestamp);
+    bool hasRoomFor(size_t const entry_length);
+    uint8_t const * findEntry(char const * name, uint16_t const identifier, Type const type, unsigned long * timestamp);
+};
+
+#endif /* ARDUINO_CLOUD_FRAME_LITE_H_ */
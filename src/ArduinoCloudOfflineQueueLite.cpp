@@ -0,0 +1,188 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "ArduinoCloudOfflineQueueLite.h"
+#include "ArduinoCloudPropertyLite.h"
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+ArduinoCloudOfflineQueueLite::ArduinoCloudOfflineQueueLite() :
+  _policy(OfflinePolicy::DropOldest),
+  _timestamp(0),
+  _dropped(0),
+  _drop_callback_func(NULL),
+  _drop_callback_context(NULL) {
+  _store.beginWrite(NULL);
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudOfflineQueueLite::clear() {
+  _store.beginWrite(NULL);
+}
+
+void ArduinoCloudOfflineQueueLite::drain(ArduinoCloudTransportLite & transport, ArduinoCloudFrameLite * frame) {
+  ArduinoCloudFrameLite::Entry entry;
+  size_t offset = 1;
+  bool sent_alone = false;
+  for (uint8_t i = 0; i < count(); i++) {
+    size_t const start = offset;
+    if (!ArduinoCloudFrameLite::parseEntry(_store.data(), _store.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry)) {
+      clear();
+      return;
+    }
+    if (frame == NULL || !frame->appendEncoded(_store.data() + start, offset - start)) {
+      char name[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH] = "";
+      if (entry.name != NULL && entry.name_length < sizeof(name)) {
+        memcpy(name, entry.name, entry.name_length);
+        name[entry.name_length] = '\0';
+      }
+      switch (entry.type) {
+        case Type::Bool:   { bool v;   ArduinoCloudFrameLite::decodeValue(entry.value, v); transport.iotWritePropertyBool(name, entry.identifier, v, entry.timestamp);   } break;
+        case Type::Int:    { int v;    ArduinoCloudFrameLite::decodeValue(entry.value, v); transport.iotWritePropertyInt(name, entry.identifier, v, entry.timestamp);    } break;
+        case Type::Float:  { float v;  ArduinoCloudFrameLite::decodeValue(entry.value, v); transport.iotWritePropertyFloat(name, entry.identifier, v, entry.timestamp);  } break;
+        case Type::String: { String v; ArduinoCloudFrameLite::decodeValue(entry.value, v); transport.iotWritePropertyString(name, entry.identifier, v, entry.timestamp); } break;
+      }
+      sent_alone = true;
+    }
+  }
+  /* The link dropped while sending the values, which may not have made it: they stay queued. The frame is flushed later on, by the
+     write cycle. The link is checked once, since that may be an exchange of its own */
+  if (sent_alone && !transport.isConnected()) {
+    return;
+  }
+  clear();
+}
+
+void ArduinoCloudOfflineQueueLite::iotReadPropertyBool(char const * /* name */, uint16_t const /* identifier */, bool & /* value */, unsigned long & /* timestamp */) {
+}
+
+void ArduinoCloudOfflineQueueLite::iotReadPropertyInt(char const * /* name */, uint16_t const /* identifier */, int & /* value */, unsigned long & /* timestamp */) {
+}
+
+void ArduinoCloudOfflineQueueLite::iotReadPropertyFloat(char const * /* name */, uint16_t const /* identifier */, float & /* value */, unsigned long & /* timestamp */) {
+}
+
+void ArduinoCloudOfflineQueueLite::iotReadPropertyString(char const * /* name */, uint16_t const /* identifier */, String & /* value */, unsigned long & /* timestamp */) {
+}
+
+void ArduinoCloudOfflineQueueLite::iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value) {
+  push(name, identifier, value);
+}
+
+void ArduinoCloudOfflineQueueLite::iotWritePropertyInt(char const * name, uint16_t const identifier, int const value) {
+  push(name, identifier, value);
+}
+
+void ArduinoCloudOfflineQueueLite::iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value) {
+  push(name, identifier, value);
+}
+
+void ArduinoCloudOfflineQueueLite::iotWritePropertyString(char const * name, uint16_t const identifier, String const & value) {
+  push(name, identifier, value);
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+template <typename T>
+void ArduinoCloudOfflineQueueLite::push(char const * name, uint16_t const identifier, T const & value) {
+  while (!_store.append(name, identifier, value, _timestamp)) {
+    /* Give up on values that do not fit an empty queue */
+    if (isEmpty()) {
+      _dropped++;
+      return;
+    }
+    if (_policy != OfflinePolicy::KeepLatest || !removeOldest(name, identifier)) {
+      dropOldest(name, identifier);
+    }
+    _dropped++;
+  }
+}
+
+bool ArduinoCloudOfflineQueueLite::findOldest(bool const byIdentifier, char const * name, uint16_t const identifier, size_t & start, size_t & end, ArduinoCloudFrameLite::Entry & entry) {
+  size_t const name_length = (name != NULL) ? strlen(name) : 0;
+  end = 1;
+  for (uint8_t i = 0; i < _store.count(); i++) {
+    start = end;
+    if (!ArduinoCloudFrameLite::parseEntry(_store.data(), _store.length(), end, ArduinoCloudFrameLite::Mode::Write, entry)) {
+      return false;
+    }
+    bool match = true;
+    if (name != NULL) {
+      if (entry.key == ArduinoCloudFrameLite::Key::Identifier) {
+        match = byIdentifier && entry.identifier == identifier;
+      } else {
+        match = !byIdentifier && entry.name_length == name_length && memcmp(entry.name, name, name_length) == 0;
+      }
+    }
+    if (match) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ArduinoCloudOfflineQueueLite::removeOldest(char const * name, uint16_t const identifier) {
+  ArduinoCloudFrameLite::Entry entry;
+  size_t start, end;
+  if (!findOldest(_store.lightPayload(), name, identifier, start, end, entry)) {
+    return false;
+  }
+  _store.remove(start, end - start);
+  return true;
+}
+
+void ArduinoCloudOfflineQueueLite::dropOldest(char const * name, uint16_t const identifier) {
+  ArduinoCloudFrameLite::Entry entry;
+  size_t start, end;
+  if (!findOldest(false, NULL, 0, start, end, entry)) {
+    return;
+  }
+  /* The key is copied, the entry does not outlive its removal */
+  bool const by_identifier = (entry.key == ArduinoCloudFrameLite::Key::Identifier);
+  uint16_t const dropped_identifier = entry.identifier;
+  char dropped_name[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH] = "";
+  if (!by_identifier && entry.name_length < sizeof(dropped_name)) {
+    memcpy(dropped_name, entry.name, entry.name_length);
+    dropped_name[entry.name_length] = '\0';
+  }
+  _store.remove(start, end - start);
+
+  if (_drop_callback_func == NULL) {
+    return;
+  }
+  /* Not the last value of its key if it is the key of the value being queued, or if a newer value with that key is queued */
+  if (by_identifier ? (_store.lightPayload() && dropped_identifier == identifier) : (!_store.lightPayload() && name != NULL && strcmp(dropped_name, name) == 0)) {
+    return;
+  }
+  if (findOldest(by_identifier, dropped_name, dropped_identifier, start, end, entry)) {
+    return;
+  }
+  _drop_callback_func(_drop_callback_context, by_identifier ? NULL : dropped_name, dropped_identifier);
+}
@@ -0,0 +1,120 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_OFFLINE_QUEUE_LITE_H_
+#define ARDUINO_CLOUD_OFFLINE_QUEUE_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#include "ArduinoCloudFrameLite.h"
+#include "ArduinoCloudTransportLite.h"
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
+
+/* What makes room for a new value once the queue is full */
+enum class OfflinePolicy : uint8_t {
+  /* The oldest queued value is dropped, even if it is the last value of its property */
+  DropOldest,
+  /* An older value of the same property is dropped if any, otherwise the oldest queued value */
+  KeepLatest
+};
+
+/* Called with the key of a value dropped while no newer value with that key is queued: name, or identifier if name is NULL */
+typedef void(*OfflineDropCallbackFunc)(void * context, char const * name, uint16_t const identifier);
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Values written while the transport is not connected, oldest first, each with the local change timestamp set by setTimestamp().
+   The values are stored as timestamped write frame entries in a single ARDUINO_CLOUD_FRAME_LITE_SIZE bytes buffer,
+   so that drain() sends them all in one frame when the transport supports frames. Reading from the queue reads nothing */
+class ArduinoCloudOfflineQueueLite : public ArduinoCloudTransportLite {
+  public:
+    ArduinoCloudOfflineQueueLite();
+
+    inline void setPolicy(OfflinePolicy const policy) {
+      _policy = policy;
+    }
+    inline OfflinePolicy policy() const {
+      return _policy;
+    }
+    /* The property which a dropped value was the last queued value of has to be published again, see OfflineDropCallbackFunc */
+    inline void onDrop(OfflineDropCallbackFunc func, void * context) {
+      _drop_callback_func = func;
+      _drop_callback_context = context;
+    }
+    /* Applies to the values queued from now on */
+    inline void setLightPayload(bool const lightPayload) {
+      _store.setLightPayload(lightPayload);
+    }
+    inline void setTimestamp(unsigned long const timestamp) {
+      _timestamp = timestamp;
+    }
+    inline int count() const {
+      return _store.count();
+    }
+    inline bool isEmpty() const {
+      return _store.count() == 0;
+    }
+    /* Number of values dropped to make room for newer ones */
+    inline unsigned long dropped() const {
+      return _dropped;
+    }
+    void clear();
+    /* Sends the queued values, oldest first, then empties the queue. To be called while the transport is connected. If frame is not NULL
+       it must have been begun in write mode on transport and the values are appended to it, otherwise they are sent one by one with
+       their timestamp. If the transport is not connected any more once they have been sent one by one, they are all kept for the next
+       drain(), and may then be sent twice */
+    void drain(ArduinoCloudTransportLite & transport, ArduinoCloudFrameLite * frame);
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp);
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp);
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp);
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp);
+
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value);
+
+  private:
+    ArduinoCloudFrameLite   _store;
+    OfflinePolicy           _policy;
+    unsigned long           _timestamp;
+    unsigned long           _dropped;
+    OfflineDropCallbackFunc _drop_callback_func;
+    void                  * _drop_callback_context;
+
+    template <typename T>
+    void push(char const * name, uint16_t const identifier, T const & value);
+    /* Sets [start, end) to the oldest value with the given key, or to the oldest value if name is NULL. Returns false if there is none.
+       byIdentifier tells which of name and identifier is the key */
+    bool findOldest(bool const byIdentifier, char const * name, uint16_t const identifier, size_t & start, size_t & end, ArduinoCloudFrameLite::Entry & entry);
+    /* Removes the oldest value with the key a value queued now would have. Returns false if there is none */
+    bool removeOldest(char const * name, uint16_t const identifier);
+    /* Removes the oldest value to make room for the value with the given key, and reports it unless it is not the last of its property */
+    void dropOldest(char const * name, uint16_t const identifier);
+};
+
+#endif /* ARDUINO_CLOUD_OFFLINE_QUEUE_LITE_H_ */
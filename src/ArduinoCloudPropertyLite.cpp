@@ -15,6 +15,8 @@
 // a commercial license, send an email to license@arduino.cc.
 //
 
+#include <string.h>
+
 #include "ArduinoCloudPropertyLite.h"
 
 #ifdef ARDUINO_ARCH_SAMD
@@ -22,6 +24,20 @@
   extern RTCZero rtc;
 #endif
 
+/* Transport the values are written to by completeNamesFit(), only the names matter */
+class NameCheckTransport : public ArduinoCloudTransportLite {
+  public:
+    virtual void iotReadPropertyBool(char const * /* name */, uint16_t const /* identifier */, bool & /* value */, unsigned long & /* timestamp */) {}
+    virtual void iotReadPropertyInt(char const * /* name */, uint16_t const /* identifier */, int & /* value */, unsigned long & /* timestamp */) {}
+    virtual void iotReadPropertyFloat(char const * /* name */, uint16_t const /* identifier */, float & /* value */, unsigned long & /* timestamp */) {}
+    virtual void iotReadPropertyString(char const * /* name */, uint16_t const /* identifier */, String & /* value */, unsigned long & /* timestamp */) {}
+    virtual void iotWritePropertyBool(char const * /* name */, uint16_t const /* identifier */, bool const /* value */) {}
+    virtual void iotWritePropertyInt(char const * /* name */, uint16_t const /* identifier */, int const /* value */) {}
+    virtual void iotWritePropertyFloat(char const * /* name */, uint16_t const /* identifier */, float const /* value */) {}
+    virtual void iotWritePropertyString(char const * /* name */, uint16_t const /* identifier */, String const & /* value */) {}
+    virtual void iotWritePropertyChars(char const * /* name */, uint16_t const /* identifier */, uint8_t const * /* value */) {}
+};
+
 static unsigned long getTimestamp() {
   #ifdef ARDUINO_ARCH_SAMD
   return rtc.getEpoch();
@@ -36,27 +52,42 @@ static unsigned long getTimestamp() {
  ******************************************************************************/
 ArduinoCloudPropertyLite::ArduinoCloudPropertyLite()
   :   _name(""),
-      _min_delta_property(0.0f),
-      _min_time_between_updates_millis(0),
-      _permission(Permission::Read),
       _update_callback_func(nullptr),
       _sync_callback_func(nullptr),
-      _has_been_updated_once(false),
-      _has_been_modified_in_callback(false),
       _last_updated_millis(0),
-      _update_interval_millis(0),
       _last_local_change_timestamp(0),
       _last_cloud_change_timestamp(0),
+      _dirty_set(NULL),
+      _name_hash(0),
       _identifier(0),
-      _attributeIdentifier(0){
+      _attributeIdentifier(0),
+      _slot(0),
+      _cloud_changed_attributes(0xFF) {
+  _policy.on_change.min_delta = 0.0f;
+  _policy.on_change.min_time_between_updates_millis = 0;
+  _flags.permission = static_cast<uint8_t>(Permission::Read);
+  _flags.update_policy = static_cast<uint8_t>(UpdatePolicy::OnChange);
+  _flags.has_been_updated_once = false;
+  _flags.has_been_modified_in_callback = false;
+  _flags.changed_attributes_only = false;
+  _flags.complete_name_overflow = false;
 }
 
 /******************************************************************************
    PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
-void ArduinoCloudPropertyLite::init(String const name, Permission const permission) {
+void ArduinoCloudPropertyLite::init(char const * name, Permission const permission) {
   _name = name;
-  _permission = permission;
+  _name_hash = static_cast<uint16_t>(hashName(_name));
+  _flags.permission = static_cast<uint8_t>(permission);
+}
+
+bool ArduinoCloudPropertyLite::completeNamesFit() {
+  NameCheckTransport check;
+  _flags.complete_name_overflow = false;
+  _flags.changed_attributes_only = false;
+  iotWritePropertyToCloud(check);
+  return !_flags.complete_name_overflow;
 }
 
 ArduinoCloudPropertyLite & ArduinoCloudPropertyLite::onUpdate(UpdateCallbackFunc func) {
@@ -70,93 +101,156 @@ ArduinoCloudPropertyLite & ArduinoCloudPropertyLite::onSync(SyncCallbackFunc fun
 }
 
 ArduinoCloudPropertyLite & ArduinoCloudPropertyLite::publishOnChange(float const min_delta_property, unsigned long const min_time_between_updates_millis) {
-  _update_policy = UpdatePolicy::OnChange;
-  _min_delta_property = min_delta_property;
-  _min_time_between_updates_millis = min_time_between_updates_millis;
+  _flags.update_policy = static_cast<uint8_t>(UpdatePolicy::OnChange);
+  _policy.on_change.min_delta = min_delta_property;
+  _policy.on_change.min_time_between_updates_millis = min_time_between_updates_millis;
   return (*this);
 }
 
-ArduinoCloudPropertyLite & ArduinoCloudPropertyLite::publishEvery(unsigned long const seconds) {
-  _update_policy = UpdatePolicy::TimeInterval;
-  _update_interval_millis = (seconds * 1000);
+ArduinoCloudPropertyLite & ArduinoCloudPropertyLite::publishEvery(unsigned long const seconds, unsigned long const tolerance_millis) {
+  _flags.update_policy = static_cast<uint8_t>(UpdatePolicy::TimeInterval);
+  _policy.time_interval.update_interval_millis = (seconds * 1000);
+  _policy.time_interval.tolerance_millis = tolerance_millis;
   return (*this);
 }
 
-void ArduinoCloudPropertyLite::iotReadPropertyFromCloud(){
-  iotReadProperty();
+void ArduinoCloudPropertyLite::iotReadPropertyFromCloud(ArduinoCloudTransportLite & transport){
+  iotReadPropertyFromCloudAs<ArduinoCloudPropertyLite>(transport);
 }
 
-void ArduinoCloudPropertyLite::iotReadPropertyReal(bool& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotReadPropertyBool(completeName.c_str(), &value, &_last_cloud_change_timestamp);
+void ArduinoCloudPropertyLite::iotReadPropertyReal(bool& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  bool const previous = value;
+  unsigned long timestamp = _last_cloud_change_timestamp;
+  transport.iotReadPropertyBool(completeName, completeIdentifier, value, timestamp);
+  setAttributeReadFromCloud(value != previous, timestamp);
 }
 
-void ArduinoCloudPropertyLite::iotReadPropertyReal(int& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotReadPropertyInt(completeName.c_str(), &value, &_last_cloud_change_timestamp);
+void ArduinoCloudPropertyLite::iotReadPropertyReal(int& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  int const previous = value;
+  unsigned long timestamp = _last_cloud_change_timestamp;
+  transport.iotReadPropertyInt(completeName, completeIdentifier, value, timestamp);
+  setAttributeReadFromCloud(value != previous, timestamp);
 }
 
-void ArduinoCloudPropertyLite::iotReadPropertyReal(float& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotReadPropertyFloat(completeName.c_str(), &value, &_last_cloud_change_timestamp);
+void ArduinoCloudPropertyLite::iotReadPropertyReal(float& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  float const previous = value;
+  unsigned long timestamp = _last_cloud_change_timestamp;
+  transport.iotReadPropertyFloat(completeName, completeIdentifier, value, timestamp);
+  setAttributeReadFromCloud(value != previous, timestamp);
 }
 
-void ArduinoCloudPropertyLite::iotReadPropertyReal(String& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotReadPropertyString(completeName.c_str(), value, &_last_cloud_change_timestamp);
+void ArduinoCloudPropertyLite::iotReadPropertyReal(String& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  unsigned long timestamp = _last_cloud_change_timestamp;
+  transport.iotReadPropertyString(completeName, completeIdentifier, value, timestamp);
+  /* Not compared, to save a copy of the String */
+  setAttributeReadFromCloud(true, timestamp);
 }
 
-void ArduinoCloudPropertyLite::iotWritePropertyToCloud(){
-  iotWriteProperty();
+void ArduinoCloudPropertyLite::iotReadPropertyChars(uint8_t * value, size_t const size, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  unsigned long timestamp = _last_cloud_change_timestamp;
+  transport.iotReadPropertyChars(completeName, completeIdentifier, value, size, timestamp);
+  setAttributeReadFromCloud(true, timestamp);
 }
 
-void ArduinoCloudPropertyLite::iotWritePropertyReal(bool& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotWritePropertyBool(completeName.c_str(), value);
+bool ArduinoCloudPropertyLite::readCloudValue(ArduinoCloudTransportLite & transport, ArduinoCloudSnapshotLite & snapshot, bool const isSyncMessage) {
+  return readCloudValueAs<ArduinoCloudPropertyLite>(transport, snapshot, isSyncMessage);
 }
 
-void ArduinoCloudPropertyLite::iotWritePropertyReal(int& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotWritePropertyInt(completeName.c_str(), value);
+void ArduinoCloudPropertyLite::iotWritePropertyToCloud(ArduinoCloudTransportLite & transport){
+  iotWritePropertyToCloudAs<ArduinoCloudPropertyLite>(transport);
 }
 
-void ArduinoCloudPropertyLite::iotWritePropertyReal(float& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotWritePropertyFloat(completeName.c_str(), value);
+void ArduinoCloudPropertyLite::iotWritePropertyReal(bool& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  transport.iotWritePropertyBool(completeName, completeIdentifier, value);
 }
 
-void ArduinoCloudPropertyLite::iotWritePropertyReal(String& value, String attributeName) {
-  String completeName = getCompleteName(attributeName);
-  WiFiLite.iotWritePropertyString(completeName.c_str(), value);
+void ArduinoCloudPropertyLite::iotWritePropertyReal(int& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
+  }
+  transport.iotWritePropertyInt(completeName, completeIdentifier, value);
 }
 
-
-bool ArduinoCloudPropertyLite::shouldBeUpdated() {
-  if (!_has_been_updated_once) {
-    return true;
+void ArduinoCloudPropertyLite::iotWritePropertyReal(float& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
   }
+  transport.iotWritePropertyFloat(completeName, completeIdentifier, value);
+}
 
-  if (_has_been_modified_in_callback) {
-    _has_been_modified_in_callback = false;
-    return true;
+void ArduinoCloudPropertyLite::iotWritePropertyReal(String& value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
   }
+  transport.iotWritePropertyString(completeName, completeIdentifier, value);
+}
 
-  if (_update_policy == UpdatePolicy::OnChange) {
-    return (isDifferentFromCloud() && ((millis() - _last_updated_millis) >= (_min_time_between_updates_millis)));
-  } else if (_update_policy == UpdatePolicy::TimeInterval) {
-    return ((millis() - _last_updated_millis) >= _update_interval_millis);
-  } else {
-    return false;
+void ArduinoCloudPropertyLite::iotWritePropertyChars(uint8_t const * value, char const * attributeName, ArduinoCloudTransportLite & transport) {
+  char buffer[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  char const * completeName = getCompleteName(attributeName, buffer);
+  uint16_t const completeIdentifier = getCompleteIdentifier(attributeName);
+  if (completeName == NULL) {
+    return;
   }
+  transport.iotWritePropertyChars(completeName, completeIdentifier, value);
+}
+
+
+bool ArduinoCloudPropertyLite::shouldBeUpdated() {
+  return shouldBeUpdatedAs<ArduinoCloudPropertyLite>();
+}
+
+void ArduinoCloudPropertyLite::updateCloudShadow() {
+  updateCloudShadowAs<ArduinoCloudPropertyLite>();
 }
 
 void ArduinoCloudPropertyLite::execCallbackOnChange() {
-  if (_update_callback_func != NULL) {
-    _update_callback_func();
-  }
-  if (!isDifferentFromCloud()) {
-    _has_been_modified_in_callback = true;
-  }
+  execCallbackOnChangeAs<ArduinoCloudPropertyLite>();
 }
 
 void ArduinoCloudPropertyLite::execCallbackOnSync() {
@@ -165,19 +259,50 @@ void ArduinoCloudPropertyLite::execCallbackOnSync() {
   }
 }
 
-String ArduinoCloudPropertyLite::getAttributeName(String propertyName, char separator) {
-  int colonPos;
-  String attributeName = "";
-  (colonPos = propertyName.indexOf(separator)) != -1 ? attributeName = propertyName.substring(colonPos + 1) : "";
-  return attributeName;
+bool ArduinoCloudPropertyLite::hasPendingUpdate() {
+  return !_flags.has_been_updated_once ||
+         _flags.has_been_modified_in_callback ||
+         isDifferentFromCloud();
+}
+
+bool ArduinoCloudPropertyLite::nextUpdateMillis(unsigned long & deadline) {
+  if (!_flags.has_been_updated_once) {
+    return false;
+  }
+  if (static_cast<UpdatePolicy>(_flags.update_policy) == UpdatePolicy::TimeInterval) {
+    deadline = _last_updated_millis + _policy.time_interval.update_interval_millis;
+    return true;
+  }
+  if (_policy.on_change.min_time_between_updates_millis != 0 && isDifferentFromCloud()) {
+    deadline = _last_updated_millis + _policy.on_change.min_time_between_updates_millis;
+    return true;
+  }
+  return false;
+}
+
+void ArduinoCloudPropertyLite::delayNextUpdate(unsigned long const deadline) {
+  if (static_cast<UpdatePolicy>(_flags.update_policy) == UpdatePolicy::TimeInterval) {
+    /* shouldBeUpdated() and nextUpdateMillis() both derive the deadline from the last update */
+    _last_updated_millis = deadline - _policy.time_interval.update_interval_millis;
+  }
 }
 
 void ArduinoCloudPropertyLite::updateLocalTimestamp() {
+  markDirty();
   if (isReadableByCloud()) {
     _last_local_change_timestamp = getTimestamp();
   }
 }
 
+uint32_t ArduinoCloudPropertyLite::hashName(char const * name) {
+  uint32_t hash = 2166136261UL;
+  while (*name != '\0') {
+    hash ^= (uint8_t)(*name++);
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
 void ArduinoCloudPropertyLite::setLastCloudChangeTimestamp(unsigned long cloudChangeEventTime) {
   _last_cloud_change_timestamp = cloudChangeEventTime;
 }
@@ -198,10 +323,37 @@ void ArduinoCloudPropertyLite::setIdentifier(int identifier) {
   _identifier = identifier;
 }
 
-String ArduinoCloudPropertyLite::getCompleteName(String attributeName){
-  String completeName = _name;
-  if (attributeName != "") {
-    completeName += ":" + attributeName;
+char const * ArduinoCloudPropertyLite::getCompleteName(char const * attributeName, char * buffer) {
+  if (*attributeName == '\0') {
+    return _name;
+  }
+  size_t const name_length = strlen(_name);
+  size_t const attribute_length = strlen(attributeName);
+  /* A truncated name could address another property */
+  if ((name_length + 1 + attribute_length) >= ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH) {
+    _flags.complete_name_overflow = true;
+    return NULL;
+  }
+  memcpy(buffer, _name, name_length);
+  buffer[name_length] = ':';
+  memcpy(&buffer[name_length + 1], attributeName, attribute_length + 1);
+  return buffer;
+}
+
+void ArduinoCloudPropertyLite::setAttributeReadFromCloud(bool const changed, unsigned long const timestamp) {
+  /* _attributeIdentifier is the index of the attribute plus 1, 0 for plain properties */
+  if (_attributeIdentifier <= 1 || timestamp > _last_cloud_change_timestamp) {
+    _last_cloud_change_timestamp = timestamp;
+  }
+  if (changed && _attributeIdentifier != 0 && _attributeIdentifier <= 8) {
+    _cloud_changed_attributes |= (1 << (_attributeIdentifier - 1));
+  }
+}
+
+uint16_t ArduinoCloudPropertyLite::getCompleteIdentifier(char const * attributeName) {
+  if (*attributeName == '\0') {
+    return _identifier;
   }
-  return completeName;
+  _attributeIdentifier++;
+  return (_attributeIdentifier << 8) | (_identifier & 0xFF);
 }
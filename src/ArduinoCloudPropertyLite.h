@@ -24,14 +24,31 @@
 
 
 #include <Arduino.h>
-#include <WiFiNINALite.h>
+#include <string.h>
+
+#include "ArduinoCloudClockLite.h"
+#include "ArduinoCloudSnapshotLite.h"
+#include "ArduinoCloudTransportLite.h"
 
 #include "lib/LinkedList/LinkedList.h"
 
-#define readProperty(x) iotReadPropertyReal(x, getAttributeName(#x, '.'))
-#define writeProperty(x) iotWritePropertyReal(x, getAttributeName(#x, '.'))
+/* The attribute name is the part of the stringified expression following the first '.', e.g. "hue" for _value.hue.
+   Its offset is resolved at compile time, so the macros expand to a pointer into the string literal itself.
+   The macros are meant to be used inside iotReadProperty(ArduinoCloudTransportLite & transport) and iotWriteProperty(ArduinoCloudTransportLite & transport)
+   and forward their transport parameter. */
+#define readProperty(x) iotReadPropertyReal(x, #x + AttributeNameOffset<getAttributeNameOffset(#x, '.')>::value, transport)
+#define writeProperty(x) iotWritePropertyReal(x, #x + AttributeNameOffset<getAttributeNameOffset(#x, '.')>::value, transport)
+/* Same as writeProperty(x) for an attribute of a composite property, which is left out of the updates sent on change
+   as long as it is equal to its cloud value y, see iotWriteAttributeReal() */
+#define writeAttribute(x, y) iotWriteAttributeReal(x, y, #x + AttributeNameOffset<getAttributeNameOffset(#x, '.')>::value, transport)
+
+/* Size of the buffer used to build the "name:attribute" identifier of composite properties, '\0' included.
+   Properties with a longer complete name are refused by the Things, see completeNamesFit() */
+#ifndef ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH
+  #define ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH 64
+#endif
 
-enum class Permission {
+enum class Permission : uint8_t {
   Read, Write, ReadWrite
 };
 
@@ -39,12 +56,27 @@ enum class Type {
   Bool, Int, Float, String
 };
 
-enum class UpdatePolicy {
+enum class UpdatePolicy : uint8_t {
   OnChange, TimeInterval
 };
 
 typedef void(*UpdateCallbackFunc)(void);
 
+/******************************************************************************
+   FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Offset of the first character following separator in expression, or of the terminating '\0' if there is no separator */
+constexpr size_t getAttributeNameOffset(char const * expression, char const separator, size_t const pos = 0) {
+  return (expression[pos] == '\0') ? pos : ((expression[pos] == separator) ? (pos + 1) : getAttributeNameOffset(expression, separator, pos + 1));
+}
+
+/* Forces the evaluation of getAttributeNameOffset() at compile time */
+template <size_t OFFSET>
+struct AttributeNameOffset {
+  static size_t const value = OFFSET;
+};
+
 /******************************************************************************
    CLASS DECLARATION
  ******************************************************************************/
@@ -53,54 +85,147 @@ class ArduinoCloudPropertyLite {
     typedef void(*SyncCallbackFunc)(ArduinoCloudPropertyLite &property);
   public:
     ArduinoCloudPropertyLite();
-    void init(String const name, Permission const permission);
+    /* name is not copied, it must outlive the property: typically a string literal */
+    void init(char const * name, Permission const permission);
 
     /* Composable configuration of the ArduinoCloudProperty class */
     ArduinoCloudPropertyLite & onUpdate(UpdateCallbackFunc func);
     ArduinoCloudPropertyLite & onSync(SyncCallbackFunc func);
     ArduinoCloudPropertyLite & publishOnChange(float const min_delta_property, unsigned long const min_time_between_updates_millis = 0);
-    ArduinoCloudPropertyLite & publishEvery(unsigned long const seconds);
+    /* With publish windows enabled on the Thing, each update may be delayed by up to tolerance_millis so that it leaves
+       together with the others, see ArduinoCloudThingLite::setPublishWindow() */
+    ArduinoCloudPropertyLite & publishEvery(unsigned long const seconds, unsigned long const tolerance_millis = 0);
 
-    inline String name() const {
+    inline char const * name() const {
       return _name;
     }
     inline int identifier() const {
       return _identifier;
     }
+    inline uint16_t nameHash() const {
+      return _name_hash;
+    }
+    inline Permission permission() const {
+      return static_cast<Permission>(_flags.permission);
+    }
     inline bool   isReadableByCloud() const {
-      return (_permission == Permission::Read) || (_permission == Permission::ReadWrite);
+      return (permission() == Permission::Read) || (permission() == Permission::ReadWrite);
     }
     inline bool   isWriteableByCloud() const {
-      return (_permission == Permission::Write) || (_permission == Permission::ReadWrite);
-    }
-
-    //read from NINA
-    void iotReadPropertyFromCloud();
-    virtual void iotReadProperty() = 0;
-    void iotReadPropertyReal(bool& value, String attributeName = "");
-    void iotReadPropertyReal(int& value, String attributeName = "");
-    void iotReadPropertyReal(float& value, String attributeName = "");
-    void iotReadPropertyReal(String& value, String attributeName = "");
-
-    //write to NINA
-    void iotWritePropertyToCloud();
-    virtual void iotWriteProperty() = 0;
-    void iotWritePropertyReal(bool& value, String attributeName = "");
-    void iotWritePropertyReal(int& value, String attributeName = "");
-    void iotWritePropertyReal(float& value, String attributeName = "");
-    void iotWritePropertyReal(String& value, String attributeName = "");
-    String getAttributeName(String propertyName, char separator);
+      return (permission() == Permission::Write) || (permission() == Permission::ReadWrite);
+    }
+    /* Whether each "name:attribute" of a composite property fits ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH.
+       The values of those which do not are neither read nor written, instead of being addressed by a truncated name */
+    bool completeNamesFit();
+
+    //read from the cloud
+    void iotReadPropertyFromCloud(ArduinoCloudTransportLite & transport);
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) = 0;
+    void iotReadPropertyReal(bool& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    void iotReadPropertyReal(int& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    void iotReadPropertyReal(float& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    void iotReadPropertyReal(String& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    /* Length-prefixed string held in a fixed size buffer, see ArduinoCloudTransportLite::iotReadPropertyChars() */
+    template <size_t SIZE>
+    void iotReadPropertyReal(uint8_t (&value)[SIZE], char const * attributeName, ArduinoCloudTransportLite & transport) {
+      iotReadPropertyChars(value, SIZE, attributeName, transport);
+    }
+    void iotReadPropertyChars(uint8_t * value, size_t const size, char const * attributeName, ArduinoCloudTransportLite & transport);
 
+    //write to the cloud
+    void iotWritePropertyToCloud(ArduinoCloudTransportLite & transport);
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) = 0;
+    void iotWritePropertyReal(bool& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    void iotWritePropertyReal(int& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    void iotWritePropertyReal(float& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    void iotWritePropertyReal(String& value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    template <size_t SIZE>
+    void iotWritePropertyReal(uint8_t (&value)[SIZE], char const * attributeName, ArduinoCloudTransportLite & transport) {
+      iotWritePropertyChars(value, attributeName, transport);
+    }
+    void iotWritePropertyChars(uint8_t const * value, char const * attributeName, ArduinoCloudTransportLite & transport);
+    /* An update sent on change carries only the attributes which differ from their cloud value. The first update, the periodic ones
+       and those following a callback carry all of them. A skipped attribute keeps its index, so that the attribute identifiers
+       do not depend on what is sent */
+    template <typename T>
+    void iotWriteAttributeReal(T & value, T const & cloudValue, char const * attributeName, ArduinoCloudTransportLite & transport) {
+      if (_flags.changed_attributes_only && value == cloudValue) {
+        _attributeIdentifier++;
+        return;
+      }
+      iotWritePropertyReal(value, attributeName, transport);
+    }
+    /* Composite properties: whether the attribute at index, in the order of iotReadProperty(), has been changed by the last read.
+       Only the first 8 attributes are tracked, the others are always reported as changed, as are all of them before the first read.
+       fromCloudToLocal() copies only the changed attributes, so that a partial update from the cloud does not revert local changes
+       of the other attributes which are still to be sent */
+    inline bool isAttributeChangedByCloud(uint8_t const index) const {
+      return (index >= 8) || (_cloud_changed_attributes & (1 << index));
+    }
+
+    /* Reads the cloud value from transport and returns whether it is to be applied: always for a sync message, otherwise if it has been
+       changed from the cloud side since the last read or, when the transport does not report timestamps, if no local change is pending.
+       A value which is not applied is replaced by the cloud value saved in snapshot beforehand, so that the local changes are still
+       published against the value they were last published with. If it can not be saved the local value is published again instead */
+    bool readCloudValue(ArduinoCloudTransportLite & transport, ArduinoCloudSnapshotLite & snapshot, bool const isSyncMessage);
     bool shouldBeUpdated();
+    /* To be called once the local value has been sent: it becomes the reference for the next shouldBeUpdated() */
+    void updateCloudShadow();
     void execCallbackOnChange();
     void execCallbackOnSync();
+
+    /* Same as the functions above, with the overriders of PROPERTY, the actual type of the property, called directly
+       instead of through the vtable so that they can be inlined. See CloudPropertyDispatch */
+    template <typename PROPERTY> void iotReadPropertyFromCloudAs(ArduinoCloudTransportLite & transport);
+    template <typename PROPERTY> void iotWritePropertyToCloudAs(ArduinoCloudTransportLite & transport);
+    template <typename PROPERTY> bool readCloudValueAs(ArduinoCloudTransportLite & transport, ArduinoCloudSnapshotLite & snapshot, bool const isSyncMessage);
+    template <typename PROPERTY> bool shouldBeUpdatedAs();
+    template <typename PROPERTY> void updateCloudShadowAs();
+    template <typename PROPERTY> void execCallbackOnChangeAs();
     void setLastCloudChangeTimestamp(unsigned long cloudChangeTime);
     void setLastLocalChangeTimestamp(unsigned long localChangeTime);
     unsigned long getLastCloudChangeTimestamp();
     unsigned long getLastLocalChangeTimestamp();
     void setIdentifier(int identifier);
 
+    /* Marks the property as locally changed, then stamps it with the local change time if it is readable by the cloud */
     void updateLocalTimestamp();
+    /* The Thing holding the property in slot keeps a bitmap of the properties which may have to be published, indexed by slot.
+       The property sets its bit when its value is assigned or modified in a callback */
+    inline void attachDirtySet(uint8_t * dirty_set, uint8_t const slot) {
+      _dirty_set = dirty_set;
+      _slot = slot;
+    }
+    inline uint8_t slot() const {
+      return _slot;
+    }
+    inline void markDirty() {
+      if (_dirty_set != NULL) {
+        _dirty_set[_slot / 8] |= (1 << (_slot % 8));
+      }
+    }
+    /* The value last sent has been lost, e.g. dropped from the offline queue: the next write cycle publishes the local value again */
+    inline void republish() {
+      if (isReadableByCloud()) {
+        _flags.has_been_modified_in_callback = true;
+        markDirty();
+      }
+    }
+    /* False once there is nothing left to publish until the next local change */
+    bool hasPendingUpdate();
+    /* Sets deadline to the cloudMillis() at which the property becomes due without any further change: the end of the interval of
+       properties published at a time interval, or the end of the minimum time between updates of a pending change.
+       Returns false if there is no such time */
+    bool nextUpdateMillis(unsigned long & deadline);
+    /* Maximum delay of an update of a property published at a time interval, 0 for other policies */
+    inline unsigned long publishToleranceMillis() const {
+      return (_flags.update_policy == static_cast<uint8_t>(UpdatePolicy::TimeInterval)) ? _policy.time_interval.tolerance_millis : 0;
+    }
+    /* Moves the next update of a property published at a time interval to deadline, given by cloudMillis() */
+    void delayNextUpdate(unsigned long const deadline);
+
+    /* FNV-1a hash of a property name, used by the Thing to index properties by name */
+    static uint32_t hashName(char const * name);
 
     virtual bool isDifferentFromCloud() = 0;
     virtual void fromCloudToLocal() = 0;
@@ -109,31 +234,63 @@ class ArduinoCloudPropertyLite {
       return false;
     };
   protected:
-    /* Variables used for UpdatePolicy::OnChange */
-    String             _name;
-    float              _min_delta_property;
-    unsigned long      _min_time_between_updates_millis;
+    char const *       _name;
+
+    /* Minimum change of the value to be published, 0 unless the property is published on change */
+    inline float minDelta() const {
+      return (_flags.update_policy == static_cast<uint8_t>(UpdatePolicy::OnChange)) ? _policy.on_change.min_delta : 0.0f;
+    }
 
   private:
-    Permission         _permission;
     UpdateCallbackFunc _update_callback_func;
     void (*_sync_callback_func)(ArduinoCloudPropertyLite &property);
 
-    UpdatePolicy       _update_policy;
-    bool               _has_been_updated_once,
-                       _has_been_modified_in_callback;
-    /* Variables used for UpdatePolicy::TimeInterval */
-    unsigned long      _last_updated_millis,
-             _update_interval_millis;
+    /* Parameters of the update policy, only those of the current policy are stored */
+    union {
+      struct {
+        float         min_delta;
+        unsigned long min_time_between_updates_millis;
+      } on_change;
+      struct {
+        unsigned long update_interval_millis;
+        unsigned long tolerance_millis;
+      } time_interval;
+    } _policy;
+
+    unsigned long      _last_updated_millis;
     /* Variables used for reconnection sync*/
     unsigned long      _last_local_change_timestamp;
     unsigned long      _last_cloud_change_timestamp;
 
+    /* Set of the Thing holding the property, see attachDirtySet() */
+    uint8_t *          _dirty_set;
+    /* Lower 16 bits of the hash of _name, computed once in init() */
+    uint16_t           _name_hash;
     /* Store the identifier of the property in the array list */
-    int                _identifier;
-    int                _attributeIdentifier;
+    uint16_t           _identifier;
+    uint8_t            _attributeIdentifier;
+    uint8_t            _slot;
+    /* Composite properties, see isAttributeChangedByCloud() */
+    uint8_t            _cloud_changed_attributes;
+    struct {
+      uint8_t permission                    : 2;
+      uint8_t update_policy                 : 1;
+      uint8_t has_been_updated_once         : 1;
+      uint8_t has_been_modified_in_callback : 1;
+      /* Set by shouldBeUpdated() for the updates sent on change, see iotWriteAttributeReal() */
+      uint8_t changed_attributes_only       : 1;
+      /* Set by getCompleteName() */
+      uint8_t complete_name_overflow        : 1;
+    } _flags;
 
-    String getCompleteName(String attributeName);
+    /* Returns _name for plain properties, otherwise builds "name:attribute" in buffer (ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH bytes).
+       Returns NULL if it does not fit */
+    char const * getCompleteName(char const * attributeName, char * buffer);
+    /* Key used instead of the name with the light payload: the identifier, with the index of the attribute (starting from 1) in the upper byte for composite properties */
+    uint16_t getCompleteIdentifier(char const * attributeName);
+    /* To be called after reading a value. The attributes of a composite property are timestamped one by one, the property keeps
+       the newest timestamp of them so that a change of any attribute is seen, not only one of the last */
+    void setAttributeReadFromCloud(bool const changed, unsigned long const timestamp);
 
 };
 
@@ -142,9 +299,145 @@ class ArduinoCloudPropertyLite {
  ******************************************************************************/
 
 inline bool operator == (ArduinoCloudPropertyLite const & lhs, ArduinoCloudPropertyLite const & rhs) {
-  return (lhs.name() == rhs.name());
+  return (strcmp(lhs.name(), rhs.name()) == 0);
+}
+
+/******************************************************************************
+   STATIC DISPATCH
+ ******************************************************************************/
+
+/* Calls the overriders of PROPERTY by their qualified name, which bypasses the vtable. Used by ArduinoCloudStaticThingLite,
+   which knows the actual type of each of its properties. For ArduinoCloudPropertyLite itself the calls are virtual */
+template <typename PROPERTY>
+struct CloudPropertyDispatch {
+  static inline void iotReadProperty(PROPERTY & property, ArduinoCloudTransportLite & transport) {
+    property.PROPERTY::iotReadProperty(transport);
+  }
+  static inline void iotWriteProperty(PROPERTY & property, ArduinoCloudTransportLite & transport) {
+    property.PROPERTY::iotWriteProperty(transport);
+  }
+  static inline bool isDifferentFromCloud(PROPERTY & property) {
+    return property.PROPERTY::isDifferentFromCloud();
+  }
+  static inline void fromLocalToCloud(PROPERTY & property) {
+    property.PROPERTY::fromLocalToCloud();
+  }
+  static inline void fromCloudToLocal(PROPERTY & property) {
+    property.PROPERTY::fromCloudToLocal();
+  }
+};
+
+template <>
+struct CloudPropertyDispatch<ArduinoCloudPropertyLite> {
+  static inline void iotReadProperty(ArduinoCloudPropertyLite & property, ArduinoCloudTransportLite & transport) {
+    property.iotReadProperty(transport);
+  }
+  static inline void iotWriteProperty(ArduinoCloudPropertyLite & property, ArduinoCloudTransportLite & transport) {
+    property.iotWriteProperty(transport);
+  }
+  static inline bool isDifferentFromCloud(ArduinoCloudPropertyLite & property) {
+    return property.isDifferentFromCloud();
+  }
+  static inline void fromLocalToCloud(ArduinoCloudPropertyLite & property) {
+    property.fromLocalToCloud();
+  }
+  static inline void fromCloudToLocal(ArduinoCloudPropertyLite & property) {
+    property.fromCloudToLocal();
+  }
+};
+
+template <typename PROPERTY>
+void ArduinoCloudPropertyLite::iotReadPropertyFromCloudAs(ArduinoCloudTransportLite & transport) {
+  _attributeIdentifier = 0;
+  _cloud_changed_attributes = 0;
+  CloudPropertyDispatch<PROPERTY>::iotReadProperty(static_cast<PROPERTY &>(*this), transport);
+}
+
+template <typename PROPERTY>
+void ArduinoCloudPropertyLite::iotWritePropertyToCloudAs(ArduinoCloudTransportLite & transport) {
+  _attributeIdentifier = 0;
+  CloudPropertyDispatch<PROPERTY>::iotWriteProperty(static_cast<PROPERTY &>(*this), transport);
+}
+
+template <typename PROPERTY>
+bool ArduinoCloudPropertyLite::readCloudValueAs(ArduinoCloudTransportLite & transport, ArduinoCloudSnapshotLite & snapshot, bool const isSyncMessage) {
+  if (isSyncMessage) {
+    iotReadPropertyFromCloudAs<PROPERTY>(transport);
+    return true;
+  }
+  unsigned long const last_cloud_change = _last_cloud_change_timestamp;
+  bool const pending = CloudPropertyDispatch<PROPERTY>::isDifferentFromCloud(static_cast<PROPERTY &>(*this));
+  snapshot.begin();
+  iotReadPropertyFromCloudAs<PROPERTY>(snapshot);
+  iotReadPropertyFromCloudAs<PROPERTY>(transport);
+  unsigned long const cloud_change = _last_cloud_change_timestamp;
+  /* Since writes are published only when due, the cloud value can lag behind a local change that is still pending */
+  if ((cloud_change == 0) ? !pending : (cloud_change != last_cloud_change)) {
+    return true;
+  }
+  if (snapshot.isComplete()) {
+    iotReadPropertyFromCloudAs<PROPERTY>(snapshot.values());
+  } else {
+    republish();
+  }
+  _last_cloud_change_timestamp = last_cloud_change;
+  _cloud_changed_attributes = 0;
+  return false;
+}
+
+template <typename PROPERTY>
+bool ArduinoCloudPropertyLite::shouldBeUpdatedAs() {
+  _flags.changed_attributes_only = false;
+  if (!_flags.has_been_updated_once) {
+    return true;
+  }
+
+  if (_flags.has_been_modified_in_callback) {
+    _flags.has_been_modified_in_callback = false;
+    return true;
+  }
+
+  UpdatePolicy const update_policy = static_cast<UpdatePolicy>(_flags.update_policy);
+  if (update_policy == UpdatePolicy::OnChange) {
+    _flags.changed_attributes_only = true;
+    return (CloudPropertyDispatch<PROPERTY>::isDifferentFromCloud(static_cast<PROPERTY &>(*this)) && ((cloudMillis() - _last_updated_millis) >= (_policy.on_change.min_time_between_updates_millis)));
+  } else if (update_policy == UpdatePolicy::TimeInterval) {
+    /* Signed, _last_updated_millis is ahead of the clock while an update is delayed to a publish window */
+    return (static_cast<long>(cloudMillis() - _last_updated_millis) >= static_cast<long>(_policy.time_interval.update_interval_millis));
+  } else {
+    return false;
+  }
+}
+
+template <typename PROPERTY>
+void ArduinoCloudPropertyLite::updateCloudShadowAs() {
+  CloudPropertyDispatch<PROPERTY>::fromLocalToCloud(static_cast<PROPERTY &>(*this));
+  _flags.has_been_updated_once = true;
+  _last_updated_millis = cloudMillis();
+}
+
+template <typename PROPERTY>
+void ArduinoCloudPropertyLite::execCallbackOnChangeAs() {
+  if (_update_callback_func != NULL) {
+    _update_callback_func();
+  }
+  if (!CloudPropertyDispatch<PROPERTY>::isDifferentFromCloud(static_cast<PROPERTY &>(*this))) {
+    _flags.has_been_modified_in_callback = true;
+    markDirty();
+  }
+}
+
+/******************************************************************************
+   SIZE BUDGET
+ ******************************************************************************/
+
+/* Upper bound of sizeof() for a property holding value_size bytes of local and cloud values.
+   The base layout is 5 pointers (vtable, name, callbacks, dirty set), 5 unsigned long (policy parameters, timestamps) and 8 bytes of
+   hash, identifiers, slot, attribute mask and flags: 48 bytes on 32 bit targets. Each type checks its own size right after its declaration */
+constexpr size_t cloudPropertySizeBudget(size_t const value_size) {
+  return ((5 * sizeof(void *) + 5 * sizeof(unsigned long) + 8 + value_size + alignof(ArduinoCloudPropertyLite) - 1) / alignof(ArduinoCloudPropertyLite)) * alignof(ArduinoCloudPropertyLite);
 }
 
-extern WiFiLiteClass WiFiLite;
+static_assert(sizeof(ArduinoCloudPropertyLite) <= cloudPropertySizeBudget(0), "ArduinoCloudPropertyLite grew past its size budget");
 
 #endif /* ARDUINO_CLOUD_PROPERTY_HPP_ */
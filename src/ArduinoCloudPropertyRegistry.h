@@ -0,0 +1,151 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_PROPERTY_REGISTRY_H_
+#define ARDUINO_CLOUD_PROPERTY_REGISTRY_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "ArduinoCloudPropertyLite.h"
+
+/******************************************************************************
+   FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Smallest power of 2 not lower than n */
+constexpr int cloudNextPowerOf2(int const n, int const p = 1) {
+  return (p >= n) ? p : cloudNextPowerOf2(n, p * 2);
+}
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Contiguous container of the properties of a Thing, over the storage of ArduinoCloudPropertyRegistry<CAPACITY>.
+   Properties are stored in registration order in a plain array (a "slot" is the index in that array),
+   and two tables index them by name hash and by identifier. No memory is allocated at registration time.
+   Slots are stored as (slot + 1) in the index tables so that 0 marks an empty entry.
+   The capacity is known at run time only, so that the code of the Thing is shared by every capacity */
+class ArduinoCloudPropertyRegistryBase {
+  public:
+    /* Identifiers are 8 bit, higher bits are used to address the attributes of a property */
+    static int const IDENTIFIER_INDEX_SIZE = 256;
+
+    inline int size() const {
+      return _size;
+    }
+    inline int capacity() const {
+      return _capacity;
+    }
+    inline bool isFull() const {
+      return _size == _capacity;
+    }
+    inline ArduinoCloudPropertyLite * get(int const slot) const {
+      return _properties[slot];
+    }
+
+    /* Returns false if the registry is full */
+    bool add(ArduinoCloudPropertyLite * property) {
+      if (isFull()) {
+        return false;
+      }
+      uint8_t const slot = _size++;
+      _properties[slot] = property;
+
+      int i = property->nameHash() & _name_index_mask;
+      while (_name_index[i] != 0) {
+        i = (i + 1) & _name_index_mask;
+      }
+      _name_index[i] = slot + 1;
+
+      // as with a linear scan, the first property registered with a given identifier wins
+      int const identifier = property->identifier();
+      if (identifier >= 0 && identifier < IDENTIFIER_INDEX_SIZE && _id_index[identifier] == 0) {
+        _id_index[identifier] = slot + 1;
+      }
+      return true;
+    }
+
+    ArduinoCloudPropertyLite * find(char const * name) const {
+      uint16_t const hash = static_cast<uint16_t>(ArduinoCloudPropertyLite::hashName(name));
+      for (int i = hash & _name_index_mask; _name_index[i] != 0; i = (i + 1) & _name_index_mask) {
+        ArduinoCloudPropertyLite * p = _properties[_name_index[i] - 1];
+        if (p->nameHash() == hash && strcmp(p->name(), name) == 0) {
+          return p;
+        }
+      }
+      return NULL;
+    }
+
+    ArduinoCloudPropertyLite * findByIdentifier(int const identifier) const {
+      if (identifier < 0 || identifier >= IDENTIFIER_INDEX_SIZE || _id_index[identifier] == 0) {
+        return NULL;
+      }
+      return _properties[_id_index[identifier] - 1];
+    }
+
+  protected:
+    /* name_index holds name_index_size entries, a power of 2, and is cleared here */
+    ArduinoCloudPropertyRegistryBase(ArduinoCloudPropertyLite ** properties, int const capacity, uint8_t * name_index, int const name_index_size) :
+      _properties(properties),
+      _name_index(name_index),
+      _name_index_mask(name_index_size - 1),
+      _capacity(capacity),
+      _size(0) {
+      memset(_name_index, 0, name_index_size);
+      memset(_id_index, 0, sizeof(_id_index));
+    }
+
+  private:
+    ArduinoCloudPropertyLite ** _properties;
+    uint8_t                   * _name_index;
+    int                         _name_index_mask;
+    uint8_t                     _capacity;
+    uint8_t                     _size;
+    uint8_t                     _id_index[IDENTIFIER_INDEX_SIZE];
+};
+
+/* Storage for CAPACITY properties. Held in a base class of its own so that it is constructed before the registry which uses it */
+template <int CAPACITY>
+class ArduinoCloudPropertyRegistryStorage {
+    static_assert(CAPACITY > 0, "ArduinoCloudPropertyRegistry: CAPACITY must be greater than 0");
+    static_assert(CAPACITY < 255, "ArduinoCloudPropertyRegistry: CAPACITY must be lower than 255");
+
+  protected:
+    /* Keep the name index at most half full so that probe sequences stay short */
+    static int const NAME_INDEX_SIZE = cloudNextPowerOf2(2 * CAPACITY);
+
+    ArduinoCloudPropertyLite * _properties[CAPACITY];
+    uint8_t                    _name_index[NAME_INDEX_SIZE];
+};
+
+template <int CAPACITY>
+class ArduinoCloudPropertyRegistry : private ArduinoCloudPropertyRegistryStorage<CAPACITY>, public ArduinoCloudPropertyRegistryBase {
+    typedef ArduinoCloudPropertyRegistryStorage<CAPACITY> Storage;
+
+  public:
+    ArduinoCloudPropertyRegistry() :
+      ArduinoCloudPropertyRegistryBase(Storage::_properties, CAPACITY, Storage::_name_index, Storage::NAME_INDEX_SIZE)
+    {}
+};
+
+#endif /* ARDUINO_CLOUD_PROPERTY_REGISTRY_H_ */
@@ -0,0 +1,165 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_PROPERTY_SCHEDULER_H_
+#define ARDUINO_CLOUD_PROPERTY_SCHEDULER_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include <string.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Min-heap of the deadlines, in cloudMillis(), at which the properties of a Thing become due without any further change.
+   A slot has at most one deadline: scheduling it again moves its deadline. Deadlines are compared through their difference,
+   so that the wrap around of the clock is handled as long as they are less than about 24 days apart.
+   _position holds (heap index + 1) for each slot, 0 when the slot is not scheduled.
+   Operates on the storage of ArduinoCloudPropertyScheduler<CAPACITY>, see ArduinoCloudPropertyRegistryBase */
+class ArduinoCloudPropertySchedulerBase {
+  public:
+    inline bool isEmpty() const {
+      return _size == 0;
+    }
+    inline int size() const {
+      return _size;
+    }
+    /* Earliest deadline, meaningless if the scheduler is empty */
+    inline unsigned long nextDeadline() const {
+      return _deadline[0];
+    }
+
+    void schedule(uint8_t const slot, unsigned long const deadline) {
+      int i = _position[slot] - 1;
+      if (i < 0) {
+        i = _size++;
+      }
+      /* The new deadline may be earlier or later than the previous one, sift in whichever direction applies */
+      i = siftUp(i, slot, deadline);
+      siftDown(i, slot, deadline);
+    }
+
+    void cancel(uint8_t const slot) {
+      int const i = _position[slot] - 1;
+      if (i < 0) {
+        return;
+      }
+      _position[slot] = 0;
+      _size--;
+      if (i < _size) {
+        uint8_t const last_slot = _slot[_size];
+        unsigned long const last_deadline = _deadline[_size];
+        int const j = siftUp(i, last_slot, last_deadline);
+        siftDown(j, last_slot, last_deadline);
+      }
+    }
+
+    /* Removes and returns the slot with the earliest deadline if it is not later than now, -1 otherwise */
+    int popDue(unsigned long const now) {
+      if (_size == 0 || isBefore(now, _deadline[0])) {
+        return -1;
+      }
+      uint8_t const slot = _slot[0];
+      cancel(slot);
+      return slot;
+    }
+
+  protected:
+    /* position is cleared here */
+    ArduinoCloudPropertySchedulerBase(uint8_t * slot, unsigned long * deadline, uint8_t * position, int const capacity) :
+      _slot(slot),
+      _deadline(deadline),
+      _position(position),
+      _size(0) {
+      memset(_position, 0, capacity);
+    }
+
+  private:
+    uint8_t       * _slot;
+    unsigned long * _deadline;
+    uint8_t       * _position;
+    uint8_t         _size;
+
+    static inline bool isBefore(unsigned long const a, unsigned long const b) {
+      return static_cast<long>(a - b) < 0;
+    }
+
+    inline void place(int const i, uint8_t const slot, unsigned long const deadline) {
+      _slot[i] = slot;
+      _deadline[i] = deadline;
+      _position[slot] = i + 1;
+    }
+
+    int siftUp(int i, uint8_t const slot, unsigned long const deadline) {
+      while (i > 0) {
+        int const parent = (i - 1) / 2;
+        if (!isBefore(deadline, _deadline[parent])) {
+          break;
+        }
+        place(i, _slot[parent], _deadline[parent]);
+        i = parent;
+      }
+      place(i, slot, deadline);
+      return i;
+    }
+
+    void siftDown(int i, uint8_t const slot, unsigned long const deadline) {
+      for (;;) {
+        int child = 2 * i + 1;
+        if (child >= _size) {
+          break;
+        }
+        if (child + 1 < _size && isBefore(_deadline[child + 1], _deadline[child])) {
+          child++;
+        }
+        if (!isBefore(_deadline[child], deadline)) {
+          break;
+        }
+        place(i, _slot[child], _deadline[child]);
+        i = child;
+      }
+      place(i, slot, deadline);
+    }
+};
+
+/* Storage for CAPACITY slots, constructed before the scheduler which uses it */
+template <int CAPACITY>
+class ArduinoCloudPropertySchedulerStorage {
+    static_assert(CAPACITY > 0, "ArduinoCloudPropertyScheduler: CAPACITY must be greater than 0");
+    static_assert(CAPACITY < 255, "ArduinoCloudPropertyScheduler: CAPACITY must be lower than 255");
+
+  protected:
+    uint8_t       _slot[CAPACITY];
+    unsigned long _deadline[CAPACITY];
+    uint8_t       _position[CAPACITY];
+};
+
+template <int CAPACITY>
+class ArduinoCloudPropertyScheduler : private ArduinoCloudPropertySchedulerStorage<CAPACITY>, public ArduinoCloudPropertySchedulerBase {
+    typedef ArduinoCloudPropertySchedulerStorage<CAPACITY> Storage;
+
+  public:
+    ArduinoCloudPropertyScheduler() :
+      ArduinoCloudPropertySchedulerBase(Storage::_slot, Storage::_deadline, Storage::_position, CAPACITY)
+    {}
+};
+
+#endif /* ARDUINO_CLOUD_PROPERTY_SCHEDULER_H_ */
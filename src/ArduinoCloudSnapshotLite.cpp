@@ -0,0 +1,61 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "ArduinoCloudSnapshotLite.h"
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+ArduinoCloudSnapshotLite::ArduinoCloudSnapshotLite(ArduinoCloudFrameLite & values) :
+  _values(values),
+  _complete(true) {
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudSnapshotLite::begin() {
+  _complete = true;
+  _values.beginResponse(NULL, 0);
+  _values.setLightPayload(true);
+}
+
+void ArduinoCloudSnapshotLite::iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp) {
+  _complete = _values.append(name, identifier, value, timestamp) && _complete;
+}
+
+void ArduinoCloudSnapshotLite::iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp) {
+  _complete = _values.append(name, identifier, value, timestamp) && _complete;
+}
+
+void ArduinoCloudSnapshotLite::iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp) {
+  _complete = _values.append(name, identifier, value, timestamp) && _complete;
+}
+
+void ArduinoCloudSnapshotLite::iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp) {
+  _complete = _values.append(name, identifier, value, timestamp) && _complete;
+}
+
+void ArduinoCloudSnapshotLite::iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const /* size */, unsigned long & timestamp) {
+  _complete = _values.appendChars(name, identifier, value, timestamp) && _complete;
+}
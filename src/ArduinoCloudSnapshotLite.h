@@ -0,0 +1,68 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_SNAPSHOT_LITE_H_
+#define ARDUINO_CLOUD_SNAPSHOT_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#include "ArduinoCloudFrameLite.h"
+#include "ArduinoCloudTransportLite.h"
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Saves the cloud value of a property, which is the reference its local changes are published against, so that it can be restored
+   after a read that is not applied, see ArduinoCloudPropertyLite::readCloudValue(). The property is read through the snapshot, which
+   appends each value to a response frame keyed by identifier without touching it, then restored by reading it back from values().
+   The frame can be one the Thing uses for something else, it is only needed until the value has been restored */
+class ArduinoCloudSnapshotLite : public ArduinoCloudTransportLite {
+  public:
+    ArduinoCloudSnapshotLite(ArduinoCloudFrameLite & values);
+
+    void begin();
+    /* False if a value did not fit the frame, the snapshot can not be restored then */
+    inline bool isComplete() const {
+      return _complete;
+    }
+    inline ArduinoCloudFrameLite & values() {
+      return _values;
+    }
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp);
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp);
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp);
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp);
+    virtual void iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp);
+
+    /* Nothing is written through a snapshot */
+    virtual void iotWritePropertyBool(char const * /* name */, uint16_t const /* identifier */, bool const /* value */) {}
+    virtual void iotWritePropertyInt(char const * /* name */, uint16_t const /* identifier */, int const /* value */) {}
+    virtual void iotWritePropertyFloat(char const * /* name */, uint16_t const /* identifier */, float const /* value */) {}
+    virtual void iotWritePropertyString(char const * /* name */, uint16_t const /* identifier */, String const & /* value */) {}
+
+  private:
+    ArduinoCloudFrameLite & _values;
+    bool                    _complete;
+};
+
+#endif /* ARDUINO_CLOUD_SNAPSHOT_LITE_H_ */
@@ -0,0 +1,397 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_STATIC_THING_LITE_H_
+#define ARDUINO_CLOUD_STATIC_THING_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "ArduinoCloudThingLite.h"
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Compile time list of references to properties of known types. forEach() is unrolled by the compiler,
+   each property being visited with its actual type */
+template <typename... PROPERTIES>
+class ArduinoCloudPropertyPack;
+
+template <>
+class ArduinoCloudPropertyPack<> {
+  public:
+    static int const SIZE = 0;
+
+    template <typename FUNCTOR>
+    inline void forEach(FUNCTOR & /* functor */, int const /* slot */ = 0) {
+    }
+};
+
+template <typename HEAD, typename... TAIL>
+class ArduinoCloudPropertyPack<HEAD, TAIL...> {
+  public:
+    static int const SIZE = 1 + sizeof...(TAIL);
+
+    ArduinoCloudPropertyPack(HEAD & head, TAIL &... tail) : _head(head), _tail(tail...) {}
+
+    /* Calls functor(slot, property) for each property, slot being its position in the pack */
+    template <typename FUNCTOR>
+    inline void forEach(FUNCTOR & functor, int const slot = 0) {
+      functor(slot, _head);
+      _tail.forEach(functor, slot + 1);
+    }
+
+  private:
+    HEAD                             & _head;
+    ArduinoCloudPropertyPack<TAIL...>  _tail;
+};
+
+/* Thing whose set of properties is known at compile time, e.g.
+
+     CloudInt  temperature;
+     CloudBool led;
+     ArduinoCloudStaticThingLite<CloudInt, CloudBool> thing(WiFiLiteTransport, temperature, led);
+
+     thing.addPropertyReal(temperature, "temperature", Permission::Read);
+     thing.addPropertyReal(led, "led", Permission::ReadWrite);
+
+   The read/write cycles are unrolled over the properties and call the functions of their actual types directly instead of through
+   the vtable, see CloudPropertyDispatch. The cycles are blocking and use the same transport features as ArduinoCloudThingLite:
+   frames, query frames, change queries and the offline queue. Properties are addressed by slot, there is no lookup by name */
+template <typename... PROPERTIES>
+class ArduinoCloudStaticThingLite {
+  public:
+    static int const SIZE = sizeof...(PROPERTIES);
+
+    ArduinoCloudStaticThingLite(ArduinoCloudTransportLite & transport, PROPERTIES &... properties) :
+      _transport(transport),
+      _properties(properties...),
+      _numDroppedProperties(0),
+      _numSuppressedWrites(0),
+      _isSyncMessage(false),
+      _lightPayload(false),
+      _snapshot(_frame),
+      _readChangedOnly(false),
+      _cloudGeneration(0) {
+      memset(_identifiers, 0, sizeof(_identifiers));
+      _offlineQueue.onDrop(onOfflineDrop, this);
+    }
+
+    void begin() {
+    }
+    inline void setLightPayload(bool const lightPayload) {
+      _lightPayload = lightPayload;
+    }
+    /* property has to be one of the properties the Thing has been constructed with, otherwise it is not synchronized and counted
+       by droppedProperties(). So is a property whose complete names do not fit, see ArduinoCloudPropertyLite::completeNamesFit(),
+       though its attributes with a name that fits are still synchronized, and a property whose identifier is not in [0, 255] or is
+       already the one of another property. If propertyIdentifier is -1 the identifier is the slot of the property plus one,
+       as ArduinoCloudThingLite numbers its properties from 1 */
+    ArduinoCloudPropertyLite & addPropertyReal(ArduinoCloudPropertyLite & property, char const * name, Permission const permission, int propertyIdentifier = -1) {
+      property.init(name, permission);
+      FindSlot find(property);
+      _properties.forEach(find);
+      int const identifier = (propertyIdentifier != -1) ? propertyIdentifier : (find.slot + 1);
+      if (find.slot < 0 || !property.completeNamesFit() || identifier < 0 || identifier > 255 ||
+          (_identifiers[identifier / 8] & (1 << (identifier % 8)))) {
+        _numDroppedProperties++;
+      } else {
+        property.setIdentifier(identifier);
+        _identifiers[identifier / 8] |= (1 << (identifier % 8));
+      }
+      return property;
+    }
+    inline int droppedProperties() const {
+      return _numDroppedProperties;
+    }
+
+    void updateTimestampOnLocallyChangedProperties() {
+      UpdateTimestamp update;
+      _properties.forEach(update);
+    }
+
+    /* If the transport supports change queries, a read cycle other than a sync one fetches only the properties changed from the cloud side */
+    void readProperties(bool isSyncMessage = false);
+    /* Publishes only the properties whose update policy says they are due */
+    void writeProperties();
+
+    inline void setOfflinePolicy(OfflinePolicy const policy) {
+      _offlineQueue.setPolicy(policy);
+    }
+    inline int offlineQueueLength() const {
+      return _offlineQueue.count();
+    }
+    inline unsigned long droppedOfflineUpdates() const {
+      return _offlineQueue.dropped();
+    }
+    inline int suppressedWrites() const {
+      return _numSuppressedWrites;
+    }
+
+  private:
+    ArduinoCloudTransportLite          & _transport;
+    ArduinoCloudPropertyPack<PROPERTIES...> _properties;
+    int                                  _numDroppedProperties;
+    int                                  _numSuppressedWrites;
+    bool                                 _isSyncMessage;
+    bool                                 _lightPayload;
+    ArduinoCloudFrameLite                _frame;
+    ArduinoCloudFrameLite                _response;
+    ArduinoCloudSnapshotLite             _snapshot;
+    ArduinoCloudOfflineQueueLite         _offlineQueue;
+    bool                                 _readChangedOnly;
+    uint32_t                             _cloudGeneration;
+    uint8_t                              _changed[ArduinoCloudTransportLite::CHANGE_BITMAP_SIZE];
+    /* Identifiers of the properties added, one bit per 8 bit identifier */
+    uint8_t                              _identifiers[ArduinoCloudTransportLite::CHANGE_BITMAP_SIZE];
+
+    inline bool isToRead(ArduinoCloudPropertyLite const & property) const {
+      int const identifier = property.identifier() & 0xFF;
+      return !_readChangedOnly || (_changed[identifier / 8] & (1 << (identifier % 8)));
+    }
+
+    template <typename PROPERTY>
+    void updateProperty(PROPERTY & property, unsigned long const cloudChangeEventTime) {
+      if (property.isWriteableByCloud()) {
+        property.setLastCloudChangeTimestamp(cloudChangeEventTime);
+        if (_isSyncMessage) {
+          property.execCallbackOnSync();
+        } else if (CloudPropertyDispatch<PROPERTY>::isDifferentFromCloud(property)) {
+          CloudPropertyDispatch<PROPERTY>::fromCloudToLocal(property);
+          property.template execCallbackOnChangeAs<PROPERTY>();
+        }
+      }
+    }
+
+    template <typename PROPERTY>
+    void readCloudValue(PROPERTY & property, ArduinoCloudTransportLite & transport) {
+      if (property.template readCloudValueAs<PROPERTY>(transport, _snapshot, _isSyncMessage)) {
+        updateProperty(property, property.getLastCloudChangeTimestamp());
+      }
+    }
+
+    /* Same as ArduinoCloudThingLite::onOfflineDrop() */
+    static void onOfflineDrop(void * context, char const * name, uint16_t const identifier) {
+      Republish republish(name, identifier);
+      static_cast<ArduinoCloudStaticThingLite *>(context)->_properties.forEach(republish);
+    }
+
+    /* Functors visiting the properties */
+
+    struct FindSlot {
+      ArduinoCloudPropertyLite const & property;
+      int                              slot;
+      FindSlot(ArduinoCloudPropertyLite const & p) : property(p), slot(-1) {}
+      template <typename PROPERTY>
+      inline void operator()(int const s, PROPERTY & p) {
+        if (slot < 0 && static_cast<ArduinoCloudPropertyLite const *>(&p) == &property) {
+          slot = s;
+        }
+      }
+    };
+
+    /* Republishes the property with the given key: name, possibly followed by ":attribute", or identifier if name is NULL */
+    struct Republish {
+      char const * name;
+      size_t       name_length;
+      uint16_t     identifier;
+      Republish(char const * n, uint16_t const i) : name(n), name_length((n != NULL) ? strcspn(n, ":") : 0), identifier(i) {}
+      template <typename PROPERTY>
+      inline void operator()(int const /* slot */, PROPERTY & p) {
+        bool const match = (name == NULL) ? ((p.identifier() & 0xFF) == (identifier & 0xFF)) :
+                           (p.name() != NULL && strncmp(p.name(), name, name_length) == 0 && p.name()[name_length] == '\0');
+        if (match) {
+          p.republish();
+        }
+      }
+    };
+
+    /* Only the wrappers of primitive types can tell a local change on their own, the overload is picked at compile time */
+    struct UpdateTimestamp {
+      template <typename PROPERTY>
+      inline void operator()(int const /* slot */, PROPERTY & p) {
+        update(p, &p);
+      }
+      template <typename PROPERTY>
+      static inline void update(PROPERTY & p, CloudWrapperBase * /* wrapper */) {
+        if (p.PROPERTY::isChangedLocally()) {
+          p.updateLocalTimestamp();
+          p.PROPERTY::takeLocalSnapshot();
+        }
+      }
+      template <typename PROPERTY>
+      static inline void update(PROPERTY & /* p */, ArduinoCloudPropertyLite * /* property */) {
+      }
+    };
+
+    /* Reads the properties of slots [first, last) from transport */
+    struct Read {
+      ArduinoCloudStaticThingLite & thing;
+      ArduinoCloudTransportLite   & transport;
+      int                           first,
+                                    last;
+      Read(ArduinoCloudStaticThingLite & t, ArduinoCloudTransportLite & tr, int const f, int const l) : thing(t), transport(tr), first(f), last(l) {}
+      template <typename PROPERTY>
+      inline void operator()(int const slot, PROPERTY & p) {
+        if (slot >= first && slot < last && thing.isToRead(p)) {
+          thing.readCloudValue(p, transport);
+        }
+      }
+    };
+
+    /* Lists in the query frame the properties from slot first on, until one does not fit. end is then the slot of that property */
+    struct Query {
+      ArduinoCloudStaticThingLite & thing;
+      int                           first,
+                                    end,
+                                    listed;
+      bool                          full;
+      Query(ArduinoCloudStaticThingLite & t, int const f) : thing(t), first(f), end(f), listed(0), full(false) {}
+      template <typename PROPERTY>
+      inline void operator()(int const slot, PROPERTY & p) {
+        if (slot < first || full) {
+          return;
+        }
+        if (thing.isToRead(p)) {
+          thing._frame.checkpoint();
+          p.template iotReadPropertyFromCloudAs<PROPERTY>(thing._frame);
+          if (thing._frame.overflowed()) {
+            thing._frame.rollback();
+            full = true;
+            return;
+          }
+          listed++;
+        }
+        end = slot + 1;
+      }
+    };
+
+    struct Write {
+      ArduinoCloudStaticThingLite & thing;
+      bool                          connected,
+                                    batched;
+      Write(ArduinoCloudStaticThingLite & t, bool const c, bool const b) : thing(t), connected(c), batched(b) {}
+      template <typename PROPERTY>
+      inline void operator()(int const /* slot */, PROPERTY & p) {
+        if (!p.template shouldBeUpdatedAs<PROPERTY>()) {
+          thing._numSuppressedWrites++;
+          return;
+        }
+        if (!connected) {
+          thing._offlineQueue.setTimestamp(p.getLastLocalChangeTimestamp());
+          p.template iotWritePropertyToCloudAs<PROPERTY>(thing._offlineQueue);
+        } else if (batched) {
+          thing._frame.beginGroup();
+          p.template iotWritePropertyToCloudAs<PROPERTY>(thing._frame);
+          thing._frame.endGroup();
+        } else {
+          p.template iotWritePropertyToCloudAs<PROPERTY>(thing._transport);
+        }
+        p.template updateCloudShadowAs<PROPERTY>();
+      }
+    };
+};
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+template <typename... PROPERTIES>
+void ArduinoCloudStaticThingLite<PROPERTIES...>::readProperties(bool isSyncMessage) {
+  if (!_transport.isConnected()) {
+    return;
+  }
+  _isSyncMessage = isSyncMessage;
+  _readChangedOnly = false;
+  /* The generation is committed once all the changed properties have been read, see ArduinoCloudThingLite::isReadCycleOver() */
+  uint32_t generation = _cloudGeneration;
+  /* A sync message reads every property, since each of them gets its sync callback */
+  if (!_isSyncMessage && _transport.supportsChangeQueries()) {
+    memset(_changed, 0, sizeof(_changed));
+    _readChangedOnly = _transport.iotReadChanges(generation, _changed, sizeof(_changed));
+  }
+
+  /* The link is checked once per cycle since that may be an exchange of its own, and once more before committing the generation */
+  if (!_transport.supportsQueryFrames()) {
+    Read read(*this, _transport, 0, SIZE);
+    _properties.forEach(read);
+    if (generation != _cloudGeneration && _transport.isConnected()) {
+      _cloudGeneration = generation;
+    }
+    return;
+  }
+
+  for (int slot = 0; slot < SIZE;) {
+    _frame.beginQuery(_transport);
+    _frame.setLightPayload(_lightPayload);
+    Query query(*this, slot);
+    _properties.forEach(query);
+    if (query.listed == 0) {
+      if (query.full) {
+        /* This property alone does not fit a frame */
+        Read read(*this, _transport, query.end, query.end + 1);
+        _properties.forEach(read);
+        query.end++;
+      }
+    } else {
+      size_t const length = _transport.iotReadProperties(_frame.data(), _frame.length(), _response.responseBuffer(), _response.capacity());
+      _response.beginResponse(&_transport, length);
+      _response.setLightPayload(_lightPayload);
+      Read read(*this, _response, slot, query.end);
+      _properties.forEach(read);
+    }
+    slot = query.end;
+  }
+  if (generation != _cloudGeneration && _transport.isConnected()) {
+    _cloudGeneration = generation;
+  }
+}
+
+template <typename... PROPERTIES>
+void ArduinoCloudStaticThingLite<PROPERTIES...>::writeProperties() {
+  bool connected = _transport.isConnected();
+  bool const batched = _transport.supportsFrames();
+  _numSuppressedWrites = 0;
+  _offlineQueue.setLightPayload(_lightPayload && batched);
+  if (connected) {
+    if (batched) {
+      _frame.beginWrite(&_transport);
+      _frame.setLightPayload(_lightPayload);
+    }
+    if (!_offlineQueue.isEmpty()) {
+      _offlineQueue.drain(_transport, batched ? &_frame : NULL);
+      /* The link dropped meanwhile */
+      if (!_offlineQueue.isEmpty()) {
+        connected = false;
+      }
+    }
+  }
+
+  Write write(*this, connected, batched);
+  _properties.forEach(write);
+
+  if (connected && batched) {
+    _frame.end();
+  }
+}
+
+#endif /* ARDUINO_CLOUD_STATIC_THING_LITE_H_ */
@@ -23,130 +23,546 @@
 
 #include <ArduinoCloudThingLite.h>
 
-
 /******************************************************************************
    CTOR/DTOR
  ******************************************************************************/
 
-ArduinoCloudThingLite::ArduinoCloudThingLite() :
+ArduinoCloudThingLiteBase::ArduinoCloudThingLiteBase(ArduinoCloudTransportLite & transport, ArduinoCloudPropertyRegistryBase & properties, ArduinoCloudPropertySchedulerBase & scheduler, uint8_t * bitmaps) :
+  _transport(transport),
+  _property_list(properties),
+  _dirty(bitmaps),
+  _wrappers(bitmaps + (properties.capacity() + 7) / 8),
+  _pendingOnChange(bitmaps + 2 * ((properties.capacity() + 7) / 8)),
+  _pendingOnSync(bitmaps + 3 * ((properties.capacity() + 7) / 8)),
+  _callbacksPending(false),
+  _callbackBudgetMillis(0),
+  _scheduler(scheduler),
+  _readPeriodMillis(0),
+  _lastReadMillis(0),
+  _hasBeenRead(false),
+  _publishWindowMillis(0),
   _numPrimitivesProperties(0),
   _numProperties(0),
-  _isSyncMessage(false)
-{}
+  _numDroppedProperties(0),
+  _numSuppressedWrites(0),
+  _isSyncMessage(false),
+  _lightPayload(false),
+  _connected(false),
+  _snapshot(_frame),
+  _changesQueried(false),
+  _readChangedOnly(false),
+  _cloudGeneration(0),
+  _pendingGeneration(0),
+  _generationPending(false),
+  _syncState(SyncState::Idle),
+  _syncSlot(0),
+  _readRequested(false),
+  _readRequestedIsSyncMessage(false),
+  _writeRequested(false),
+  _read_complete_callback_func(NULL),
+  _write_complete_callback_func(NULL) {
+  memset(bitmaps, 0, 4 * ((properties.capacity() + 7) / 8));
+  _offlineQueue.onDrop(onOfflineDrop, this);
+}
 
 /******************************************************************************
    PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
 
-void ArduinoCloudThingLite::begin() {
+void ArduinoCloudThingLiteBase::begin() {
 }
 
-ArduinoCloudPropertyLite& ArduinoCloudThingLite::addPropertyReal(ArduinoCloudPropertyLite & property, String const & name, Permission const permission, int propertyIdentifier) {
+ArduinoCloudPropertyLite& ArduinoCloudThingLiteBase::addPropertyReal(ArduinoCloudPropertyLite & property, char const * name, Permission const permission, int propertyIdentifier) {
   property.init(name, permission);
   if (isPropertyInContainer(name)) {
     return (*getProperty(name));
+  } else if (_property_list.isFull()) {
+    // the property is not synchronized with the cloud, declare an ArduinoCloudSizedThingLite of a larger capacity
+    _numDroppedProperties++;
+    return (property);
+  } else if (!property.completeNamesFit()) {
+    // the property is not synchronized with the cloud, shorten its name or increase ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH
+    _numDroppedProperties++;
+    return (property);
+  } else if (!isIdentifierFree((propertyIdentifier != -1) ? propertyIdentifier : (_numProperties + 1))) {
+    // the property is not synchronized with the cloud, identifiers are 8 bit and each property needs its own
+    _numDroppedProperties++;
+    return (property);
   } else {
+    int const slot = _property_list.size();
     if (property.isPrimitive()) {
       _numPrimitivesProperties++;
+      _wrappers[slot / 8] |= (1 << (slot % 8));
     }
     _numProperties++;
     addProperty(&property, propertyIdentifier);
+    /* Never published yet */
+    property.attachDirtySet(_dirty, slot);
+    property.markDirty();
     return (property);
   }
 
 }
 
-void ArduinoCloudThingLite::readProperties(bool isSyncMessage) {
-  _isSyncMessage = isSyncMessage;
-  
-  for (int i = 0; i < _property_list.size(); i++) {
-    ArduinoCloudPropertyLite * p = _property_list.get(i);
-    p->iotReadProperty();
-    updateProperty(p->name(),0);
-  }
+void ArduinoCloudThingLiteBase::readProperties(bool isSyncMessage) {
+  while (poll());
+
+  beginReadCycle(isSyncMessage);
+  int slot = 0;
+  while (!readStep(slot));
+  dispatchCallbacks();
 }
 
-void ArduinoCloudThingLite::writeProperties() {
-  
-  for (int i = 0; i < _property_list.size(); i++) {
-    ArduinoCloudPropertyLite * p = _property_list.get(i);
-    p->iotWriteProperty();
-  }
+void ArduinoCloudThingLiteBase::writeProperties() {
+  while (poll());
+
+  beginWriteCycle();
+  int slot = 0;
+  while (!writeStep(slot));
+}
+
+void ArduinoCloudThingLiteBase::beginReadProperties(bool isSyncMessage) {
+  _readRequested = true;
+  _readRequestedIsSyncMessage = isSyncMessage;
 }
 
-bool ArduinoCloudThingLite::isPropertyInContainer(String const & name) {
-  for (int i = 0; i < _property_list.size(); i++) {
-    ArduinoCloudPropertyLite * p = _property_list.get(i);
-    if (p->name() == name) {
+void ArduinoCloudThingLiteBase::beginWriteProperties() {
+  _writeRequested = true;
+}
+
+bool ArduinoCloudThingLiteBase::dispatchCallbacks() {
+  if (!_callbacksPending) {
+    return false;
+  }
+  unsigned long const start = cloudMillis();
+  int const size = _property_list.size();
+  for (int slot = 0; slot < size; slot++) {
+    if ((_pendingOnSync[slot / 8] | _pendingOnChange[slot / 8]) == 0) {
+      /* Skip the rest of the byte */
+      slot |= 7;
+      continue;
+    }
+    uint8_t const bit = (1 << (slot % 8));
+    if (((_pendingOnSync[slot / 8] | _pendingOnChange[slot / 8]) & bit) == 0) {
+      continue;
+    }
+    ArduinoCloudPropertyLite * p = _property_list.get(slot);
+    if (_pendingOnSync[slot / 8] & bit) {
+      _pendingOnSync[slot / 8] &= ~bit;
+      p->execCallbackOnSync();
+    }
+    if (_pendingOnChange[slot / 8] & bit) {
+      _pendingOnChange[slot / 8] &= ~bit;
+      p->execCallbackOnChange();
+    }
+    /* At least one property is dispatched per call. If none is left the next call finds it out */
+    if (_callbackBudgetMillis != 0 && (cloudMillis() - start) >= _callbackBudgetMillis) {
       return true;
     }
   }
+  _callbacksPending = false;
   return false;
 }
 
-//retrieve property by name
-ArduinoCloudPropertyLite * ArduinoCloudThingLite::getProperty(String const & name) {
-  for (int i = 0; i < _property_list.size(); i++) {
-    ArduinoCloudPropertyLite * p = _property_list.get(i);
-    if (p->name() == name) {
-      return p;
+bool ArduinoCloudThingLiteBase::poll() {
+  if (_syncState == SyncState::Idle) {
+    /* The callbacks queued by a read cycle are drained before the next cycle starts: a write cycle would otherwise
+       overwrite the cloud value an onSync callback is still to apply */
+    if (_callbacksPending) {
+      dispatchCallbacks();
+      return _callbacksPending || _writeRequested || _readRequested;
+    }
+    if (_writeRequested) {
+      _writeRequested = false;
+      beginWriteCycle();
+      _syncState = SyncState::Write;
+    } else if (_readRequested) {
+      _readRequested = false;
+      beginReadCycle(_readRequestedIsSyncMessage);
+      _syncState = SyncState::Read;
+    } else {
+      return false;
+    }
+    _syncSlot = 0;
+  }
+
+  if (_syncState == SyncState::Write) {
+    if (writeStep(_syncSlot)) {
+      _syncState = SyncState::Idle;
+      if (_write_complete_callback_func != NULL) {
+        _write_complete_callback_func();
+      }
+    }
+  } else {
+    if (readStep(_syncSlot)) {
+      _syncState = SyncState::Idle;
+      dispatchCallbacks();
+      if (_read_complete_callback_func != NULL) {
+        _read_complete_callback_func();
+      }
     }
   }
-  return NULL;
+
+  return (_syncState != SyncState::Idle) || _writeRequested || _readRequested || _callbacksPending;
 }
 
-//retrieve property by identifier
-ArduinoCloudPropertyLite * ArduinoCloudThingLite::getProperty(int const & pos) {
-  for (int i = 0; i < _property_list.size(); i++) {
-    ArduinoCloudPropertyLite * p = _property_list.get(i);
-    if (p->identifier() == pos) {
-      return p;
+unsigned long ArduinoCloudThingLiteBase::nextDeadlineMillis() const {
+  if (nextSlotIn(_dirty, 0) < _property_list.size()) {
+    return 0;
+  }
+  if (_scheduler.isEmpty()) {
+    return NO_DEADLINE;
+  }
+  long const remaining = static_cast<long>(_scheduler.nextDeadline() - cloudMillis());
+  return (remaining > 0) ? remaining : 0;
+}
+
+bool ArduinoCloudThingLiteBase::isReadDue() const {
+  return (_readPeriodMillis != 0) && (!_hasBeenRead || (cloudMillis() - _lastReadMillis) >= _readPeriodMillis);
+}
+
+unsigned long ArduinoCloudThingLiteBase::nextActionMillis() const {
+  if (_syncState != SyncState::Idle || _readRequested || _writeRequested || _callbacksPending) {
+    return 0;
+  }
+  unsigned long next = nextDeadlineMillis();
+  if (_readPeriodMillis != 0) {
+    unsigned long const elapsed = cloudMillis() - _lastReadMillis;
+    unsigned long const read = (!_hasBeenRead || elapsed >= _readPeriodMillis) ? 0 : (_readPeriodMillis - elapsed);
+    if (read < next) {
+      next = read;
     }
   }
-  return NULL;
+  return next;
+}
+
+bool ArduinoCloudThingLiteBase::isPropertyInContainer(char const * name) {
+  return (getProperty(name) != NULL);
 }
 
-// this function updates the timestamps on the primitive properties that have been modified locally since last cloud synchronization
-void ArduinoCloudThingLite::updateTimestampOnLocallyChangedProperties() {
+//retrieve property by name
+ArduinoCloudPropertyLite * ArduinoCloudThingLiteBase::getProperty(char const * name) {
+  return _property_list.find(name);
+}
+
+//retrieve property by identifier
+ArduinoCloudPropertyLite * ArduinoCloudThingLiteBase::getProperty(int const & pos) {
+  return _property_list.findByIdentifier(pos);
+}
+
+// this function updates the timestamps on the primitive properties that have been modified locally since the last call, and marks them dirty
+void ArduinoCloudThingLiteBase::updateTimestampOnLocallyChangedProperties() {
   if (_numPrimitivesProperties == 0) {
     return;
   } else {
-    for (int i = 0; i < _property_list.size(); i++) {
+    for (int i = nextSlotIn(_wrappers, 0); i < _property_list.size(); i = nextSlotIn(_wrappers, i + 1)) {
       CloudWrapperBase * p = (CloudWrapperBase *)_property_list.get(i);
-      if (p->isPrimitive() && p->isChangedLocally() && p->isReadableByCloud()) {
+      if (p->isChangedLocally()) {
         p->updateLocalTimestamp();
+        p->takeLocalSnapshot();
       }
     }
   }
 }
 
 
-void ArduinoCloudThingLite::updateProperty(String propertyName, unsigned long cloudChangeEventTime) {
+void ArduinoCloudThingLiteBase::updateProperty(char const * propertyName, unsigned long cloudChangeEventTime) {
   ArduinoCloudPropertyLite* property = getProperty(propertyName);
-  if (property && property->isWriteableByCloud()) {
-    property->setLastCloudChangeTimestamp(cloudChangeEventTime);
+  if (property) {
+    updateProperty(*property, cloudChangeEventTime);
+  }
+}
+
+void ArduinoCloudThingLiteBase::updateProperty(ArduinoCloudPropertyLite & property, unsigned long cloudChangeEventTime) {
+  if (property.isWriteableByCloud()) {
+    property.setLastCloudChangeTimestamp(cloudChangeEventTime);
+    /* The callbacks are queued, see dispatchCallbacks() */
+    uint8_t const slot = property.slot();
     if (_isSyncMessage) {
-      property->execCallbackOnSync();
+      _pendingOnSync[slot / 8] |= (1 << (slot % 8));
+      _callbacksPending = true;
     } else {
-      if(property->isDifferentFromCloud()){
-        property->fromCloudToLocal();
-        property->execCallbackOnChange();
+      if(property.isDifferentFromCloud()){
+        property.fromCloudToLocal();
+        _pendingOnChange[slot / 8] |= (1 << (slot % 8));
+        _callbacksPending = true;
       }
     }
   }
 }
 
-// retrieve the property name by the identifier
-String ArduinoCloudThingLite::getPropertyNameByIdentifier(int propertyIdentifier) {
-  ArduinoCloudPropertyLite* property;
+// retrieve the property by the identifier, the upper bits of identifiers greater than 255 address an attribute and are ignored
+ArduinoCloudPropertyLite * ArduinoCloudThingLiteBase::getPropertyByIdentifier(int propertyIdentifier) {
   if (propertyIdentifier > 255) {
-    property = getProperty(propertyIdentifier & 255);
+    return getProperty(propertyIdentifier & 255);
   } else {
-    property = getProperty(propertyIdentifier);
+    return getProperty(propertyIdentifier);
+  }
+}
+
+// retrieve the property name by the identifier, NULL if no property has that identifier
+char const * ArduinoCloudThingLiteBase::getPropertyNameByIdentifier(int propertyIdentifier) {
+  ArduinoCloudPropertyLite* property = getPropertyByIdentifier(propertyIdentifier);
+  if (property == NULL) {
+    return NULL;
   }
   return property->name();
 }
 
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudThingLiteBase::readCloudValue(ArduinoCloudPropertyLite & property, ArduinoCloudTransportLite & transport) {
+  if (property.readCloudValue(transport, _snapshot, _isSyncMessage)) {
+    updateProperty(property, property.getLastCloudChangeTimestamp());
+  }
+}
+
+void ArduinoCloudThingLiteBase::beginReadCycle(bool isSyncMessage) {
+  _hasBeenRead = true;
+  _lastReadMillis = cloudMillis();
+  _isSyncMessage = isSyncMessage;
+  _connected = _transport.isConnected();
+  _changesQueried = false;
+  _readChangedOnly = false;
+  _generationPending = false;
+}
+
+/* First slot from slot on holding a property to be read in the current cycle */
+int ArduinoCloudThingLiteBase::nextSlotToRead(int slot) const {
+  if (_readChangedOnly) {
+    for (; slot < _property_list.size(); slot++) {
+      int const identifier = _property_list.get(slot)->identifier() & 0xFF;
+      if (_changed[identifier / 8] & (1 << (identifier % 8))) {
+        break;
+      }
+    }
+  }
+  return slot;
+}
+
+/* First slot from slot on whose bit is set in set, or the number of properties if there is none. Bytes without any bit set are skipped at once */
+int ArduinoCloudThingLiteBase::nextSlotIn(uint8_t const * set, int slot) const {
+  int const size = _property_list.size();
+  while (slot < size) {
+    uint8_t const bits = set[slot / 8] >> (slot % 8);
+    if (bits == 0) {
+      slot = (slot / 8 + 1) * 8;
+    } else if (bits & 1) {
+      return slot;
+    } else {
+      slot++;
+    }
+  }
+  return size;
+}
+
+/* First publish window boundary not earlier than deadline, if it is at most tolerance later. Windows are anchored at 0 so that
+   every Thing with the same window shares them, the wrap around of the clock shifts them once */
+unsigned long ArduinoCloudThingLiteBase::alignToPublishWindow(unsigned long const deadline, unsigned long const tolerance) const {
+  if (_publishWindowMillis == 0 || tolerance == 0) {
+    return deadline;
+  }
+  unsigned long const delay = (_publishWindowMillis - (deadline % _publishWindowMillis)) % _publishWindowMillis;
+  return (delay <= tolerance) ? (deadline + delay) : deadline;
+}
+
+/* Performs one transport exchange of the read cycle starting from slot: the change query, a single property, or a batch of them.
+   Returns true once all the properties have been read, or right away if the transport is not connected */
+bool ArduinoCloudThingLiteBase::readStep(int & slot) {
+  if (!_connected) {
+    return true;
+  }
+  if (!_changesQueried) {
+    _changesQueried = true;
+    /* A sync message reads every property, since each of them gets its sync callback */
+    if (!_isSyncMessage && _transport.supportsChangeQueries()) {
+      memset(_changed, 0, sizeof(_changed));
+      _pendingGeneration = _cloudGeneration;
+      _readChangedOnly = _transport.iotReadChanges(_pendingGeneration, _changed, sizeof(_changed));
+      _generationPending = true;
+      slot = nextSlotToRead(slot);
+      return isReadCycleOver(slot);
+    }
+  }
+
+  slot = nextSlotToRead(slot);
+  if (slot >= _property_list.size()) {
+    return isReadCycleOver(slot);
+  }
+
+  if (!_transport.supportsQueryFrames()) {
+    readCloudValue(*_property_list.get(slot), _transport);
+    slot = nextSlotToRead(slot + 1);
+    return isReadCycleOver(slot);
+  }
+
+  /* List as many properties as fit in the query frame, a property is either listed entirely or left to the next query */
+  _frame.beginQuery(_transport);
+  _frame.setLightPayload(_lightPayload);
+  int last = slot;
+  while (last < _property_list.size()) {
+    _frame.checkpoint();
+    _property_list.get(last)->iotReadPropertyFromCloud(_frame);
+    if (_frame.overflowed()) {
+      _frame.rollback();
+      break;
+    }
+    last = nextSlotToRead(last + 1);
+  }
+
+  if (last == slot) {
+    /* This property alone does not fit a frame */
+    readCloudValue(*_property_list.get(slot), _transport);
+    slot = nextSlotToRead(slot + 1);
+    return isReadCycleOver(slot);
+  }
+
+  size_t const length = _transport.iotReadProperties(_frame.data(), _frame.length(), _response.responseBuffer(), _response.capacity());
+  _response.beginResponse(&_transport, length);
+  _response.setLightPayload(_lightPayload);
+  for (; slot < last; slot = nextSlotToRead(slot + 1)) {
+    readCloudValue(*_property_list.get(slot), _response);
+  }
+  return isReadCycleOver(slot);
+}
+
+/* Returns true once the read cycle is over: every property to be read has been read, or the link was down when it started.
+   The generation returned by the change query is committed only if the link is still up by then, so that the changes a cycle cut
+   short by the link did not read are reported again */
+bool ArduinoCloudThingLiteBase::isReadCycleOver(int const slot) {
+  if (!_connected) {
+    return true;
+  }
+  if (slot < _property_list.size()) {
+    return false;
+  }
+  if (_generationPending && _transport.isConnected()) {
+    _cloudGeneration = _pendingGeneration;
+    _generationPending = false;
+  }
+  return true;
+}
+
+void ArduinoCloudThingLiteBase::beginWriteCycle() {
+  _numSuppressedWrites = 0;
+  _connected = _transport.isConnected();
+  /* Wrappers are not notified of the changes of the variable they wrap, check them before publishing */
+  updateTimestampOnLocallyChangedProperties();
+  unsigned long const now = cloudMillis();
+  for (int due = _scheduler.popDue(now); due >= 0; due = _scheduler.popDue(now)) {
+    _dirty[due / 8] |= (1 << (due % 8));
+  }
+  bool const batched = _transport.supportsFrames();
+  _offlineQueue.setLightPayload(_lightPayload && batched);
+  if (batched) {
+    _frame.beginWrite(&_transport);
+    _frame.setLightPayload(_lightPayload);
+  }
+}
+
+/* Performs one transport exchange of the write cycle starting from slot: a single property, or a full frame.
+   Returns true once all the due properties have been sent. While the transport is not connected the due properties are queued
+   in a single step */
+bool ArduinoCloudThingLiteBase::writeStep(int & slot) {
+  bool const batched = _transport.supportsFrames();
+  if (slot == 0 && _connected && !_offlineQueue.isEmpty()) {
+    /* The queued values leave first. Without a frame they make up the exchange of this step, and the next step finds the queue empty,
+       unless the link dropped meanwhile: the rest of the cycle then queues the due properties */
+    _offlineQueue.drain(_transport, batched ? &_frame : NULL);
+    if (!_offlineQueue.isEmpty()) {
+      _connected = false;
+    }
+    if (!batched) {
+      return (slot >= _property_list.size());
+    }
+  }
+  bool const connected = _connected;
+
+  /* Only the dirty properties are visited, the others are not due */
+  while (slot < _property_list.size()) {
+    int const next = nextSlotIn(_dirty, slot);
+    _numSuppressedWrites += next - slot;
+    slot = next;
+    if (slot >= _property_list.size()) {
+      break;
+    }
+    ArduinoCloudPropertyLite * p = _property_list.get(slot);
+    uint8_t const flushes = _frame.flushes();
+    bool const due = p->shouldBeUpdated();
+    if (due) {
+      if (!connected) {
+        _offlineQueue.setTimestamp(p->getLastLocalChangeTimestamp());
+        p->iotWritePropertyToCloud(_offlineQueue);
+      } else if (!batched) {
+        p->iotWritePropertyToCloud(_transport);
+      } else {
+        /* The attributes of a composite property leave in the same frame */
+        _frame.beginGroup();
+        p->iotWritePropertyToCloud(_frame);
+        _frame.endGroup();
+      }
+      p->updateCloudShadow();
+    } else {
+      _numSuppressedWrites++;
+    }
+    /* A property which will become due at a given time waits in the scheduler instead of being visited by every cycle */
+    unsigned long deadline;
+    if (p->nextUpdateMillis(deadline)) {
+      unsigned long const aligned = alignToPublishWindow(deadline, p->publishToleranceMillis());
+      if (aligned != deadline) {
+        p->delayNextUpdate(aligned);
+        deadline = aligned;
+      }
+      _scheduler.schedule(slot, deadline);
+      _dirty[slot / 8] &= ~(1 << (slot % 8));
+    } else {
+      _scheduler.cancel(slot);
+      if (!p->hasPendingUpdate()) {
+        _dirty[slot / 8] &= ~(1 << (slot % 8));
+      }
+    }
+    slot++;
+    if (due && connected) {
+      /* Without a frame each property is an exchange, with a frame an exchange happens when it gets flushed */
+      if (!batched) {
+        return (slot >= _property_list.size());
+      }
+      if (_frame.flushes() != flushes) {
+        return false;
+      }
+    }
+  }
+
+  if (connected && batched) {
+    _frame.end();
+  }
+  return true;
+}
+
+/* The shadow of a queued property is updated as soon as its value is queued, the value dropped would otherwise never be published */
+void ArduinoCloudThingLiteBase::onOfflineDrop(void * context, char const * name, uint16_t const identifier) {
+  ArduinoCloudThingLiteBase * thing = static_cast<ArduinoCloudThingLiteBase *>(context);
+  ArduinoCloudPropertyLite * property = NULL;
+  if (name == NULL) {
+    property = thing->getPropertyByIdentifier(identifier);
+  } else {
+    /* The attributes of a composite property are queued as "name:attribute" */
+    char property_name[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+    size_t const length = strcspn(name, ":");
+    if (length >= sizeof(property_name)) {
+      return;
+    }
+    memcpy(property_name, name, length);
+    property_name[length] = '\0';
+    property = thing->getProperty(property_name);
+  }
+  if (property != NULL) {
+    property->republish();
+  }
+}
+
 void onAutoSync(ArduinoCloudPropertyLite & property) {
   if (property.getLastCloudChangeTimestamp() > property.getLastLocalChangeTimestamp()) {
     property.fromCloudToLocal();
@@ -22,34 +22,51 @@
    INCLUDE
  ******************************************************************************/
 
+#include "ArduinoCloudFrameLite.h"
+#include "ArduinoCloudOfflineQueueLite.h"
 #include "ArduinoCloudPropertyLite.h"
-#include "lib/LinkedList/LinkedList.h"
+#include "ArduinoCloudPropertyRegistry.h"
+#include "ArduinoCloudPropertyScheduler.h"
+#include "ArduinoCloudTransportLite.h"
 #include "types/CloudBool.h"
 #include "types/CloudFloat.h"
 #include "types/CloudInt.h"
 #include "types/CloudString.h"
-//#include "types/CloudLocation.h"
-//#include "types/CloudColor.h"
+#include "types/CloudFixedString.h"
+#include "types/CloudLocation.h"
+#include "types/CloudColor.h"
 #include "types/CloudWrapperBase.h"
 
-//#include "types/automation/CloudColoredLight.h"
-//#include "types/automation/CloudContactSensor.h"
-//#include "types/automation/CloudDimmedLight.h"
-//#include "types/automation/CloudLight.h"
-//#include "types/automation/CloudMotionSensor.h"
-//#include "types/automation/CloudSmartPlug.h"
-//#include "types/automation/CloudSwitch.h"
-//#include "types/automation/CloudTemperature.h"
-//#include "types/automation/CloudTelevision.h"
+#include "types/automation/CloudColoredLight.h"
+#include "types/automation/CloudContactSensor.h"
+#include "types/automation/CloudDimmedLight.h"
+#include "types/automation/CloudLight.h"
+#include "types/automation/CloudMotionSensor.h"
+#include "types/automation/CloudSmartPlug.h"
+#include "types/automation/CloudSwitch.h"
+#include "types/automation/CloudTemperature.h"
+#include "types/automation/CloudTelevision.h"
 
 
 /******************************************************************************
    CONSTANTS
  ******************************************************************************/
 
+/* The capacity is a template parameter of ArduinoCloudSizedThingLite, a build flag would change the layout of the Thing
+   between the files compiled with and without it */
+#ifdef ARDUINO_CLOUD_THING_LITE_MAX_PROPERTIES
+  #error "ARDUINO_CLOUD_THING_LITE_MAX_PROPERTIES is gone, declare an ArduinoCloudSizedThingLite<capacity> instead"
+#endif
+
+/* Number of properties an ArduinoCloudThingLite can hold */
+static int const ARDUINO_CLOUD_THING_LITE_DEFAULT_CAPACITY = 32;
+
 static bool const ON  = true;
 static bool const OFF = false;
 
+/* Returned by ArduinoCloudThingLite::nextDeadlineMillis() when no property will become due without a local change */
+static unsigned long const NO_DEADLINE = 0xFFFFFFFFUL;
+
 static long const ON_CHANGE = -1;
 static long const SECONDS   = 1;
 static long const MINUTES   = 60;
@@ -67,36 +84,169 @@ void onForceCloudSync(ArduinoCloudPropertyLite & property);
 void onForceDeviceSync(ArduinoCloudPropertyLite & property);
 #define DEVICE_WINS onForceDeviceSync // The device property value is already the correct one. The cloud property value will be synchronized at the next update cycle.
 
+typedef void(*SyncCompleteCallbackFunc)(void);
+
 /******************************************************************************
    CLASS DECLARATION
  ******************************************************************************/
 
-class ArduinoCloudThingLite {
+/* Synchronization logic shared by the Things of every capacity. The per-property storage is owned by ArduinoCloudSizedThingLite,
+   declare one of those, or an ArduinoCloudThingLite for the default capacity.
+   RAM on a 32 bit MCU: each slot costs 12.5 to 14 bytes whether it is used or not, i.e. the registry pointer (4) and its name index
+   entries (2 to 3.5, the index being rounded up to a power of 2), the scheduler slot, deadline and position (1 + 4 + 1) and one bit
+   in each of the 4 slot bitmaps (0.5). On top of that come about 1.3 kB whatever the capacity: the frames _frame and _response and
+   the store of the offline queue (3 x ARDUINO_CLOUD_FRAME_LITE_SIZE, 256 bytes by default, plus about 40 bytes of state each),
+   the identifier index (256) and the change bitmap (32). The default capacity of 32 thus takes about 1.7 kB, 150 about 3.4 kB */
+class ArduinoCloudThingLiteBase {
 
   public:
-    ArduinoCloudThingLite();
-
     void begin();
-    //if propertyIdentifier is different from -1, an integer identifier is associated to the added property to be use instead of the property name when the parameter lightPayload is true in the encode method
-    ArduinoCloudPropertyLite   & addPropertyReal(ArduinoCloudPropertyLite   & property, String const & name, Permission const permission, int propertyIdentifier = -1);
+    /* With the light payload, batched transfers address properties and their attributes by identifier instead of by name */
+    inline void setLightPayload(bool const lightPayload) {
+      _lightPayload = lightPayload;
+    }
+    //if propertyIdentifier is different from -1, an integer identifier is associated to the added property to be used instead of the property name when the light payload is enabled with setLightPayload()
+    //name is not copied, it must outlive the Thing: typically a string literal
+    ArduinoCloudPropertyLite   & addPropertyReal(ArduinoCloudPropertyLite   & property, char const * name, Permission const permission, int propertyIdentifier = -1);
 
-    bool isPropertyInContainer(String const & name);
+    bool isPropertyInContainer(char const * name);
+    /* Number of properties that could not be added because the capacity of the Thing was reached, because their
+       complete names do not fit, see ArduinoCloudPropertyLite::completeNamesFit(), or because their identifier is not in [0, 255]
+       or is already the one of another property, be it given explicitly or assigned in registration order */
+    inline int droppedProperties() const {
+      return _numDroppedProperties;
+    }
 
     void updateTimestampOnLocallyChangedProperties();
-    void updateProperty(String propertyName, unsigned long cloudChangeEventTime);
-    String getPropertyNameByIdentifier(int propertyIdentifier);
+    void updateProperty(char const * propertyName, unsigned long cloudChangeEventTime);
+    ArduinoCloudPropertyLite * getPropertyByIdentifier(int propertyIdentifier);
+    char const * getPropertyNameByIdentifier(int propertyIdentifier);
 
+    /* Blocking read/write cycles, an asynchronous cycle in progress is completed first.
+       If the transport supports change queries, a read cycle other than a sync one fetches only the properties changed from the cloud side */
     void readProperties(bool isSyncMessage = false);
+    /* Publishes only the properties whose update policy says they are due */
     void writeProperties();
 
+    /* onUpdate/onSync callbacks are not called while reading: the values read are applied first and the callbacks are queued,
+       a property being queued at most once per kind of callback. The queue is drained once the read cycle is over, within
+       budgetMillis if not 0, what is left being drained by the next calls of poll() or dispatchCallbacks() before any other cycle starts */
+    inline void setCallbackBudget(unsigned long const budgetMillis) {
+      _callbackBudgetMillis = budgetMillis;
+    }
+    /* Calls the queued callbacks within the budget, returns true if some are still queued */
+    bool dispatchCallbacks();
+
+    /* Asynchronous read/write cycles: they are carried out by poll(), one transport exchange per call.
+       A requested write is performed before a requested read */
+    void beginReadProperties(bool isSyncMessage = false);
+    void beginWriteProperties();
+    /* Returns true while a cycle is in progress or pending, or while callbacks are queued */
+    bool poll();
+    inline bool isSyncInProgress() const {
+      return _syncState != SyncState::Idle;
+    }
+    inline void onReadComplete(SyncCompleteCallbackFunc func) {
+      _read_complete_callback_func = func;
+    }
+    inline void onWriteComplete(SyncCompleteCallbackFunc func) {
+      _write_complete_callback_func = func;
+    }
+    /* While the transport is not connected, due properties are queued with their local change timestamp instead of being sent,
+       and sent before any other value by the first write cycle once connected again */
+    inline void setOfflinePolicy(OfflinePolicy const policy) {
+      _offlineQueue.setPolicy(policy);
+    }
+    inline int offlineQueueLength() const {
+      return _offlineQueue.count();
+    }
+    inline unsigned long droppedOfflineUpdates() const {
+      return _offlineQueue.dropped();
+    }
+    /* Milliseconds until the next property becomes due, 0 if one may be due already, NO_DEADLINE if none will become due
+       without a local change. Changes of wrapped variables are only seen once updateTimestampOnLocallyChangedProperties() ran */
+    unsigned long nextDeadlineMillis() const;
+    /* Low power hint: milliseconds until the Thing has work to do, the earliest of nextDeadlineMillis(), the next read period
+       and 0 while a cycle or callbacks are pending. NO_DEADLINE if nothing is expected before a local change.
+       The application may sleep the MCU and the radio that long, provided the clock given to setCloudClock() keeps running */
+    unsigned long nextActionMillis() const;
+    /* Period of the reads of the application, 0 if it reads on demand only. A read is due once the period has elapsed since
+       the start of the last read cycle */
+    inline void setReadPeriod(unsigned long const periodMillis) {
+      _readPeriodMillis = periodMillis;
+    }
+    bool isReadDue() const;
+    /* Publish windows: when not 0, the updates of properties published at a time interval are delayed, within the tolerance
+       given to publishEvery(), to the next multiple of windowMillis of cloudMillis(), so that they leave in a single burst */
+    inline void setPublishWindow(unsigned long const windowMillis) {
+      _publishWindowMillis = windowMillis;
+    }
+    /* Number of properties that were not due and therefore not sent by the last writeProperties() */
+    inline int suppressedWrites() const {
+      return _numSuppressedWrites;
+    }
+
+  protected:
+    /* bitmaps holds the 4 slot bitmaps, of (capacity + 7) / 8 bytes each, it is cleared here */
+    ArduinoCloudThingLiteBase(ArduinoCloudTransportLite & transport, ArduinoCloudPropertyRegistryBase & properties, ArduinoCloudPropertySchedulerBase & scheduler, uint8_t * bitmaps);
+
   private:
-    LinkedList<ArduinoCloudPropertyLite *>   _property_list;
+    enum class SyncState : uint8_t {
+      Idle, Read, Write
+    };
+
+    ArduinoCloudTransportLite          & _transport;
+    ArduinoCloudPropertyRegistryBase   & _property_list;
+    /* Bitmaps indexed by slot: properties which may have to be published, see ArduinoCloudPropertyLite::attachDirtySet(),
+       and wrappers of primitive types, whose changes can only be detected by comparing their value */
+    uint8_t                            * _dirty;
+    uint8_t                            * _wrappers;
+    /* Properties whose onUpdate/onSync callback is queued, indexed by slot */
+    uint8_t                            * _pendingOnChange;
+    uint8_t                            * _pendingOnSync;
+    bool                                 _callbacksPending;
+    unsigned long                        _callbackBudgetMillis;
+    /* Properties which will become due at a given time: they are marked dirty once it has come */
+    ArduinoCloudPropertySchedulerBase  & _scheduler;
+    /* See setReadPeriod(), _lastReadMillis is meaningful once _hasBeenRead */
+    unsigned long                        _readPeriodMillis;
+    unsigned long                        _lastReadMillis;
+    bool                                 _hasBeenRead;
+    unsigned long                        _publishWindowMillis;
     /* Keep track of the number of primitive properties in the Thing. If 0 it allows the early exit in updateTimestampOnLocallyChangedProperties() */
     int                                  _numPrimitivesProperties;
     int                                  _numProperties;
+    int                                  _numDroppedProperties;
+    int                                  _numSuppressedWrites;
     /* Indicates the if the message received to be decoded is a response to the getLastValues inquiry */
     bool                                 _isSyncMessage;
-    
+    bool                                 _lightPayload;
+    /* State of the link, read once at the start of each cycle since that may be an exchange of its own, e.g. on WiFiLite */
+    bool                                 _connected;
+    /* Outgoing values, or the query sent by readProperties(), are packed here when the transport accepts batched transfers */
+    ArduinoCloudFrameLite                _frame;
+    /* Answer of the transport to the query sent by readProperties() */
+    ArduinoCloudFrameLite                _response;
+    /* Cloud values are saved in _frame while they are read, the query held there has been answered by then */
+    ArduinoCloudSnapshotLite             _snapshot;
+    ArduinoCloudOfflineQueueLite         _offlineQueue;
+    /* Properties changed from the cloud side since _cloudGeneration, indexed by identifier. Used by the read cycle if _readChangedOnly.
+       The generation returned by the change query is held in _pendingGeneration until the cycle has read all of them */
+    bool                                 _changesQueried,
+                                         _readChangedOnly;
+    uint32_t                             _cloudGeneration,
+                                         _pendingGeneration;
+    bool                                 _generationPending;
+    uint8_t                              _changed[ArduinoCloudTransportLite::CHANGE_BITMAP_SIZE];
+    /* State of the asynchronous cycle driven by poll(), _syncSlot is the next property to be processed */
+    SyncState                            _syncState;
+    int                                  _syncSlot;
+    bool                                 _readRequested,
+                                         _readRequestedIsSyncMessage,
+                                         _writeRequested;
+    SyncCompleteCallbackFunc             _read_complete_callback_func;
+    SyncCompleteCallbackFunc             _write_complete_callback_func;
+
     inline void addProperty(ArduinoCloudPropertyLite   * property_obj, int propertyIdentifier) {
       if (propertyIdentifier != -1) {
         property_obj->setIdentifier(propertyIdentifier);
@@ -106,9 +256,58 @@ class ArduinoCloudThingLite {
       }
       _property_list.add(property_obj);
     }
-    ArduinoCloudPropertyLite * getProperty(String const & name);
+    ArduinoCloudPropertyLite * getProperty(char const * name);
     ArduinoCloudPropertyLite * getProperty(int const & identifier);
+    /* The upper bits of an identifier address an attribute, see getPropertyByIdentifier() */
+    inline bool isIdentifierFree(int const identifier) const {
+      return (identifier >= 0) && (identifier <= 255) && (_property_list.findByIdentifier(identifier) == NULL);
+    }
+    void updateProperty(ArduinoCloudPropertyLite & property, unsigned long cloudChangeEventTime);
+    void readCloudValue(ArduinoCloudPropertyLite & property, ArduinoCloudTransportLite & transport);
+    void beginReadCycle(bool isSyncMessage);
+    void beginWriteCycle();
+    int nextSlotToRead(int slot) const;
+    int nextSlotIn(uint8_t const * set, int slot) const;
+    unsigned long alignToPublishWindow(unsigned long const deadline, unsigned long const tolerance) const;
+    bool readStep(int & slot);
+    bool isReadCycleOver(int const slot);
+    bool writeStep(int & slot);
+    /* See ArduinoCloudOfflineQueueLite::onDrop(), context is the Thing */
+    static void onOfflineDrop(void * context, char const * name, uint16_t const identifier);
+
+};
+
+/* Per-property storage of a Thing of CAPACITY properties. Held in a base class of its own so that it is constructed before
+   ArduinoCloudThingLiteBase, which uses it */
+template <int CAPACITY>
+class ArduinoCloudThingLiteStorage {
+  protected:
+    static int const BITMAP_SIZE = (CAPACITY + 7) / 8;
 
+    ArduinoCloudPropertyRegistry<CAPACITY>  _registry;
+    ArduinoCloudPropertyScheduler<CAPACITY> _schedule;
+    uint8_t                                 _bitmaps[4 * BITMAP_SIZE];
+};
+
+/* Thing holding up to CAPACITY properties, at most 254. The capacity is part of the type, so that every file sees the same layout */
+template <int CAPACITY>
+class ArduinoCloudSizedThingLite : private ArduinoCloudThingLiteStorage<CAPACITY>, public ArduinoCloudThingLiteBase {
+    typedef ArduinoCloudThingLiteStorage<CAPACITY> Storage;
+
+  public:
+    ArduinoCloudSizedThingLite(ArduinoCloudTransportLite & transport) :
+      ArduinoCloudThingLiteBase(transport, Storage::_registry, Storage::_schedule, Storage::_bitmaps)
+    {}
+};
+
+class ArduinoCloudThingLite : public ArduinoCloudSizedThingLite<ARDUINO_CLOUD_THING_LITE_DEFAULT_CAPACITY> {
+
+  public:
+    /* Synchronizes through WiFiLite, see ArduinoCloudTransportWiFiLite */
+    ArduinoCloudThingLite();
+    ArduinoCloudThingLite(ArduinoCloudTransportLite & transport) :
+      ArduinoCloudSizedThingLite<ARDUINO_CLOUD_THING_LITE_DEFAULT_CAPACITY>(transport)
+    {}
 };
 
 #endif /* ARDUINO_CLOUD_THING_H_ */
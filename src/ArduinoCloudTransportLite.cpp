@@ -0,0 +1,41 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "ArduinoCloudTransportLite.h"
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudTransportLite::iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp) {
+  String string(reinterpret_cast<char const *>(&value[1]));
+  iotReadPropertyString(name, identifier, string, timestamp);
+  size_t const length = (string.length() > (size - 2)) ? (size - 2) : string.length();
+  value[0] = length;
+  memcpy(&value[1], string.c_str(), length);
+  value[1 + length] = '\0';
+}
+
+void ArduinoCloudTransportLite::iotWritePropertyChars(char const * name, uint16_t const identifier, uint8_t const * value) {
+  iotWritePropertyString(name, identifier, String(reinterpret_cast<char const *>(&value[1])));
+}
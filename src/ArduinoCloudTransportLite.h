@@ -0,0 +1,99 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_TRANSPORT_LITE_H_
+#define ARDUINO_CLOUD_TRANSPORT_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Link between a Thing and the cloud. Values are addressed by their complete name ("name" or "name:attribute")
+   and by their complete identifier, the latter being meaningful only when the light payload is enabled.
+   Transports able to exchange ArduinoCloudFrameLite frames advertise it through supportsFrames()/supportsQueryFrames(). */
+class ArduinoCloudTransportLite {
+  public:
+    virtual ~ArduinoCloudTransportLite() {}
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp) = 0;
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp) = 0;
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp) = 0;
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp) = 0;
+
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value) = 0;
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value) = 0;
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value) = 0;
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value) = 0;
+
+    /* Values changed locally at timestamp and sent late, e.g. by the offline queue. By default the timestamp is dropped */
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value, unsigned long const /* timestamp */) {
+      iotWritePropertyBool(name, identifier, value);
+    }
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value, unsigned long const /* timestamp */) {
+      iotWritePropertyInt(name, identifier, value);
+    }
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value, unsigned long const /* timestamp */) {
+      iotWritePropertyFloat(name, identifier, value);
+    }
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value, unsigned long const /* timestamp */) {
+      iotWritePropertyString(name, identifier, value);
+    }
+
+    /* Strings held in a size bytes buffer: value[0] is the length, followed by the characters and a '\0'. Longer values are truncated.
+       By default they go through iotReadPropertyString()/iotWritePropertyString(), transports override them to avoid the String */
+    virtual void iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp);
+    virtual void iotWritePropertyChars(char const * name, uint16_t const identifier, uint8_t const * value);
+
+    /* While not connected the Thing queues its writes and skips its reads */
+    virtual bool isConnected() {
+      return true;
+    }
+
+    /* Size of the bitmap filled by iotReadChanges(), one bit per 8 bit property identifier */
+    static size_t const CHANGE_BITMAP_SIZE = 32;
+
+    virtual bool supportsFrames() {
+      return false;
+    }
+    virtual bool supportsQueryFrames() {
+      return false;
+    }
+    virtual bool supportsChangeQueries() {
+      return false;
+    }
+    /* Sends a write frame */
+    virtual void iotWriteProperties(uint8_t const * /* frame */, size_t const /* length */) {
+    }
+    /* Sends a query frame and stores the response frame in response, returns the length of the response */
+    virtual size_t iotReadProperties(uint8_t const * /* query */, size_t const /* length */, uint8_t * /* response */, size_t const /* size */) {
+      return 0;
+    }
+    /* Sets bit (identifier % 8) of changed[identifier / 8] for each property changed from the cloud side since generation, the upper
+       byte of attribute identifiers being ignored, then updates generation to the current one. Returns false if the changes can not be
+       told apart, in which case every property has to be read. changed is cleared by the caller */
+    virtual bool iotReadChanges(uint32_t & /* generation */, uint8_t * /* changed */, size_t const /* size */) {
+      return false;
+    }
+};
+
+#endif /* ARDUINO_CLOUD_TRANSPORT_LITE_H_ */
@@ -0,0 +1,354 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "ArduinoCloudTransportLoopback.h"
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+ArduinoCloudTransportLoopback::ArduinoCloudTransportLoopback() :
+  _size(0),
+  _connected(true),
+  _frames(true),
+  _change_queries(true),
+  _generation(0),
+  _call_latency_micros(0),
+  _byte_latency_micros(0),
+  _calls(0),
+  _bytes(0),
+  _latency_micros(0)
+{}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudTransportLoopback::resetCounters() {
+  _calls = 0;
+  _bytes = 0;
+  _latency_micros = 0;
+}
+
+bool ArduinoCloudTransportLoopback::setCloudValue(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp) {
+  return set(name, identifier, value, &timestamp);
+}
+
+bool ArduinoCloudTransportLoopback::setCloudValue(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp) {
+  return set(name, identifier, value, &timestamp);
+}
+
+bool ArduinoCloudTransportLoopback::setCloudValue(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp) {
+  return set(name, identifier, value, &timestamp);
+}
+
+bool ArduinoCloudTransportLoopback::setCloudValue(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp) {
+  return set(name, identifier, value, &timestamp);
+}
+
+bool ArduinoCloudTransportLoopback::getCloudValue(char const * name, uint16_t const identifier, bool & value) {
+  return get(name, identifier, value, NULL);
+}
+
+bool ArduinoCloudTransportLoopback::getCloudValue(char const * name, uint16_t const identifier, int & value) {
+  return get(name, identifier, value, NULL);
+}
+
+bool ArduinoCloudTransportLoopback::getCloudValue(char const * name, uint16_t const identifier, float & value) {
+  return get(name, identifier, value, NULL);
+}
+
+bool ArduinoCloudTransportLoopback::getCloudValue(char const * name, uint16_t const identifier, String & value) {
+  return get(name, identifier, value, NULL);
+}
+
+void ArduinoCloudTransportLoopback::iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp) {
+  if (exchange(0)) {
+    get(name, identifier, value, &timestamp);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp) {
+  if (exchange(0)) {
+    get(name, identifier, value, &timestamp);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp) {
+  if (exchange(0)) {
+    get(name, identifier, value, &timestamp);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp) {
+  if (exchange(0)) {
+    get(name, identifier, value, &timestamp);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp) {
+  if (!exchange(0)) {
+    return;
+  }
+  Value const * v = lookup(name, identifier, false);
+  if (v == NULL || v->type != Type::String) {
+    return;
+  }
+  size_t const length = (v->string_value.length() > (size - 2)) ? (size - 2) : v->string_value.length();
+  value[0] = length;
+  memcpy(&value[1], v->string_value.c_str(), length);
+  value[1 + length] = '\0';
+  timestamp = v->timestamp;
+}
+
+void ArduinoCloudTransportLoopback::iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value) {
+  if (exchange(0)) {
+    set(name, identifier, value, NULL);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotWritePropertyInt(char const * name, uint16_t const identifier, int const value) {
+  if (exchange(0)) {
+    set(name, identifier, value, NULL);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value) {
+  if (exchange(0)) {
+    set(name, identifier, value, NULL);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotWritePropertyString(char const * name, uint16_t const identifier, String const & value) {
+  if (exchange(0)) {
+    set(name, identifier, value, NULL);
+  }
+}
+
+void ArduinoCloudTransportLoopback::iotWriteProperties(uint8_t const * frame, size_t const length) {
+  if (!exchange(length)) {
+    return;
+  }
+  ArduinoCloudFrameLite::Entry entry;
+  size_t offset = 1;
+  for (uint8_t i = 0; i < frame[0] && ArduinoCloudFrameLite::parseEntry(frame, length, offset, ArduinoCloudFrameLite::Mode::Write, entry); i++) {
+    Value * value = lookup(entry, true);
+    if (value == NULL) {
+      continue;
+    }
+    switch (entry.type) {
+      case Type::Bool:   ArduinoCloudFrameLite::decodeValue(entry.value, value->bool_value);   break;
+      case Type::Int:    ArduinoCloudFrameLite::decodeValue(entry.value, value->int_value);    break;
+      case Type::Float:  ArduinoCloudFrameLite::decodeValue(entry.value, value->float_value);  break;
+      case Type::String: ArduinoCloudFrameLite::decodeValue(entry.value, value->string_value); break;
+    }
+    value->type = entry.type;
+  }
+}
+
+size_t ArduinoCloudTransportLoopback::iotReadProperties(uint8_t const * query, size_t const length, uint8_t * response, size_t const size) {
+  if (!_connected) {
+    exchange(length);
+    return 0;
+  }
+  _response.beginResponse(NULL, 0);
+  ArduinoCloudFrameLite::Entry entry;
+  size_t offset = 1;
+  for (uint8_t i = 0; i < query[0] && ArduinoCloudFrameLite::parseEntry(query, length, offset, ArduinoCloudFrameLite::Mode::Query, entry); i++) {
+    Value const * value = lookup(entry, false);
+    if (value != NULL && value->type == entry.type && !appendResponse(*value, entry)) {
+      break;
+    }
+  }
+  size_t const response_length = (_response.length() > size) ? 0 : _response.length();
+  memcpy(response, _response.data(), response_length);
+  exchange(length + response_length);
+  return response_length;
+}
+
+bool ArduinoCloudTransportLoopback::iotReadChanges(uint32_t & generation, uint8_t * changed, size_t const size) {
+  if (!exchange(sizeof(generation) + size)) {
+    return false;
+  }
+  bool known = true;
+  for (int i = 0; i < _size; i++) {
+    Value const & value = _values[i];
+    if (value.generation <= generation) {
+      continue;
+    }
+    long const identifier = value.identifier & 0xFF;
+    if (value.identifier < 0 || static_cast<size_t>(identifier / 8) >= size) {
+      known = false;
+    } else {
+      changed[identifier / 8] |= (1 << (identifier % 8));
+    }
+  }
+  generation = _generation;
+  return known;
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+template <typename T>
+bool ArduinoCloudTransportLoopback::set(char const * name, uint16_t const identifier, T const & value, unsigned long const * timestamp) {
+  Value * v = lookup(name, identifier, true);
+  if (v == NULL) {
+    return false;
+  }
+  store(*v, value);
+  if (timestamp != NULL) {
+    v->timestamp = *timestamp;
+    v->generation = ++_generation;
+  }
+  return true;
+}
+
+template <typename T>
+bool ArduinoCloudTransportLoopback::get(char const * name, uint16_t const identifier, T & value, unsigned long * timestamp) {
+  Value const * v = lookup(name, identifier, false);
+  if (v == NULL || !load(*v, value)) {
+    return false;
+  }
+  if (timestamp != NULL) {
+    *timestamp = v->timestamp;
+  }
+  return true;
+}
+
+void ArduinoCloudTransportLoopback::store(Value & value, bool const v) {
+  value.type = Type::Bool;
+  value.bool_value = v;
+}
+
+void ArduinoCloudTransportLoopback::store(Value & value, int const v) {
+  value.type = Type::Int;
+  value.int_value = v;
+}
+
+void ArduinoCloudTransportLoopback::store(Value & value, float const v) {
+  value.type = Type::Float;
+  value.float_value = v;
+}
+
+void ArduinoCloudTransportLoopback::store(Value & value, String const & v) {
+  value.type = Type::String;
+  value.string_value = v;
+}
+
+bool ArduinoCloudTransportLoopback::load(Value const & value, bool & v) {
+  if (value.type != Type::Bool) {
+    return false;
+  }
+  v = value.bool_value;
+  return true;
+}
+
+bool ArduinoCloudTransportLoopback::load(Value const & value, int & v) {
+  if (value.type != Type::Int) {
+    return false;
+  }
+  v = value.int_value;
+  return true;
+}
+
+bool ArduinoCloudTransportLoopback::load(Value const & value, float & v) {
+  if (value.type != Type::Float) {
+    return false;
+  }
+  v = value.float_value;
+  return true;
+}
+
+bool ArduinoCloudTransportLoopback::load(Value const & value, String & v) {
+  if (value.type != Type::String) {
+    return false;
+  }
+  v = value.string_value;
+  return true;
+}
+
+bool ArduinoCloudTransportLoopback::exchange(size_t const bytes) {
+  unsigned long const latency = _call_latency_micros + bytes * _byte_latency_micros;
+  _calls++;
+  _bytes += bytes;
+  _latency_micros += latency;
+  if (latency > 0) {
+    delay(latency / 1000);
+    delayMicroseconds(latency % 1000);
+  }
+  return _connected;
+}
+
+/* A value is looked up by name when there is one, otherwise by identifier. Looking it up by name also records its identifier, if known */
+ArduinoCloudTransportLoopback::Value * ArduinoCloudTransportLoopback::lookup(char const * name, long const identifier, bool const create) {
+  bool const by_name = (name != NULL && *name != '\0');
+  for (int i = 0; i < _size; i++) {
+    Value & value = _values[i];
+    if (by_name ? (strcmp(value.name, name) == 0) : (value.identifier == identifier)) {
+      if (identifier >= 0) {
+        value.identifier = identifier;
+      }
+      return &value;
+    }
+  }
+  if (!create || _size == ARDUINO_CLOUD_TRANSPORT_LOOPBACK_MAX_VALUES || (by_name && strlen(name) >= sizeof(_values[0].name))) {
+    return NULL;
+  }
+  Value & value = _values[_size++];
+  strcpy(value.name, by_name ? name : "");
+  value.identifier = identifier;
+  value.timestamp = 0;
+  value.generation = 0;
+  return &value;
+}
+
+ArduinoCloudTransportLoopback::Value * ArduinoCloudTransportLoopback::lookup(ArduinoCloudFrameLite::Entry const & entry, bool const create) {
+  if (entry.key == ArduinoCloudFrameLite::Key::Identifier) {
+    return lookup(NULL, entry.identifier, create);
+  }
+  char name[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+  if (entry.name_length >= sizeof(name)) {
+    return NULL;
+  }
+  memcpy(name, entry.name, entry.name_length);
+  name[entry.name_length] = '\0';
+  return lookup(name, -1, create);
+}
+
+bool ArduinoCloudTransportLoopback::appendResponse(Value const & value, ArduinoCloudFrameLite::Entry const & entry) {
+  char name[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH] = "";
+  if (entry.name != NULL) {
+    memcpy(name, entry.name, entry.name_length);
+    name[entry.name_length] = '\0';
+  }
+  _response.setLightPayload(entry.key == ArduinoCloudFrameLite::Key::Identifier);
+  switch (value.type) {
+    case Type::Bool:   return _response.append(name, entry.identifier, value.bool_value, value.timestamp);
+    case Type::Int:    return _response.append(name, entry.identifier, value.int_value, value.timestamp);
+    case Type::Float:  return _response.append(name, entry.identifier, value.float_value, value.timestamp);
+    case Type::String: return _response.append(name, entry.identifier, value.string_value, value.timestamp);
+  }
+  return false;
+}
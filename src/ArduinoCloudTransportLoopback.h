@@ -0,0 +1,171 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_TRANSPORT_LOOPBACK_H_
+#define ARDUINO_CLOUD_TRANSPORT_LOOPBACK_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#include "ArduinoCloudFrameLite.h"
+#include "ArduinoCloudPropertyLite.h"
+#include "ArduinoCloudTransportLite.h"
+
+/******************************************************************************
+   CONSTANTS
+ ******************************************************************************/
+
+/* Maximum number of values the loopback can hold, enough for the largest Thing. Can be overridden from the build flags */
+#ifndef ARDUINO_CLOUD_TRANSPORT_LOOPBACK_MAX_VALUES
+  #define ARDUINO_CLOUD_TRANSPORT_LOOPBACK_MAX_VALUES 256
+#endif
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* In-memory transport standing in for the cloud, meant to run and measure the sync logic off-target.
+   Written values are stored and read back, the cloud side is simulated with setCloudValue()/getCloudValue().
+   Values are keyed by name, or by identifier when they come from a light payload frame. Values never written
+   are left out of query responses and left untouched by single reads. The timestamp of a value is the time of its
+   last change from the cloud side, values written by the device keep it. Changes from the cloud side are also
+   numbered by a generation counter, which iotReadChanges() reports them against.
+   Each call waits for the configured latency, plus a per byte latency for frames, and is accounted in
+   calls(), bytes() and latencyMicros(). */
+class ArduinoCloudTransportLoopback : public ArduinoCloudTransportLite {
+  public:
+    ArduinoCloudTransportLoopback();
+
+    inline void setLatency(unsigned long const call_micros, unsigned long const byte_micros = 0) {
+      _call_latency_micros = call_micros;
+      _byte_latency_micros = byte_micros;
+    }
+    inline void setFramesSupported(bool const frames) {
+      _frames = frames;
+    }
+    /* While disconnected calls are accounted but have no effect */
+    inline void setConnected(bool const connected) {
+      _connected = connected;
+    }
+    inline void setChangeQueriesSupported(bool const changeQueries) {
+      _change_queries = changeQueries;
+    }
+    inline unsigned long calls() const {
+      return _calls;
+    }
+    inline unsigned long bytes() const {
+      return _bytes;
+    }
+    inline unsigned long latencyMicros() const {
+      return _latency_micros;
+    }
+    void resetCounters();
+
+    /* Cloud side: name may be NULL to address a value by identifier only. setCloudValue() returns false if the loopback is full,
+       getCloudValue() if the value is unknown or of another type */
+    bool setCloudValue(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp);
+    bool setCloudValue(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp);
+    bool setCloudValue(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp);
+    bool setCloudValue(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp);
+    bool getCloudValue(char const * name, uint16_t const identifier, bool & value);
+    bool getCloudValue(char const * name, uint16_t const identifier, int & value);
+    bool getCloudValue(char const * name, uint16_t const identifier, float & value);
+    bool getCloudValue(char const * name, uint16_t const identifier, String & value);
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp);
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp);
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp);
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp);
+    /* Copies the stored string, without the String of the default implementation, so that tests can tell whether the read path allocates */
+    virtual void iotReadPropertyChars(char const * name, uint16_t const identifier, uint8_t * value, size_t const size, unsigned long & timestamp);
+
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value);
+
+    virtual bool isConnected() {
+      return _connected;
+    }
+    virtual bool supportsFrames() {
+      return _frames;
+    }
+    virtual bool supportsQueryFrames() {
+      return _frames;
+    }
+    virtual bool supportsChangeQueries() {
+      return _change_queries;
+    }
+    virtual void iotWriteProperties(uint8_t const * frame, size_t const length);
+    virtual size_t iotReadProperties(uint8_t const * query, size_t const length, uint8_t * response, size_t const size);
+    virtual bool iotReadChanges(uint32_t & generation, uint8_t * changed, size_t const size);
+
+  private:
+    struct Value {
+      char          name[ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH];
+      /* -1 until known */
+      long          identifier;
+      Type          type;
+      bool          bool_value;
+      int           int_value;
+      float         float_value;
+      String        string_value;
+      unsigned long timestamp;
+      /* Generation of the last change from the cloud side, 0 if none */
+      uint32_t      generation;
+    };
+
+    Value                 _values[ARDUINO_CLOUD_TRANSPORT_LOOPBACK_MAX_VALUES];
+    int                   _size;
+    bool                  _connected,
+                          _frames,
+                          _change_queries;
+    /* Incremented on each change from the cloud side */
+    uint32_t              _generation;
+    unsigned long         _call_latency_micros,
+                          _byte_latency_micros;
+    unsigned long         _calls,
+                          _bytes,
+                          _latency_micros;
+    /* Scratch frame used to build query responses */
+    ArduinoCloudFrameLite _response;
+
+    template <typename T>
+    bool set(char const * name, uint16_t const identifier, T const & value, unsigned long const * timestamp);
+    template <typename T>
+    bool get(char const * name, uint16_t const identifier, T & value, unsigned long * timestamp);
+    static void store(Value & value, bool const v);
+    static void store(Value & value, int const v);
+    static void store(Value & value, float const v);
+    static void store(Value & value, String const & v);
+    static bool load(Value const & value, bool & v);
+    static bool load(Value const & value, int & v);
+    static bool load(Value const & value, float & v);
+    static bool load(Value const & value, String & v);
+
+    /* Returns false while disconnected */
+    bool exchange(size_t const bytes);
+    /* Returns NULL if the value is unknown and create is false, or if the loopback is full */
+    Value * lookup(char const * name, long const identifier, bool const create);
+    Value * lookup(ArduinoCloudFrameLite::Entry const & entry, bool const create);
+    bool appendResponse(Value const & value, ArduinoCloudFrameLite::Entry const & entry);
+};
+
+#endif /* ARDUINO_CLOUD_TRANSPORT_LOOPBACK_H_ */
@@ -0,0 +1,239 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "ArduinoCloudTransportWiFiLite.h"
+#include "ArduinoCloudThingLite.h"
+
+/******************************************************************************
+   LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/* The overloads below are selected at compile time depending on the methods exposed by the WiFiLite in use */
+template <typename T>
+static auto supportsFrames(T & wifi, int) -> decltype(wifi.iotWriteProperties((uint8_t const *)0, (size_t)0), bool()) {
+  return true;
+}
+
+template <typename T>
+static bool supportsFrames(T & /* wifi */, long) {
+  return false;
+}
+
+template <typename T>
+static auto supportsQueryFrames(T & wifi, int) -> decltype(wifi.iotReadProperties((uint8_t const *)0, (size_t)0, (uint8_t *)0, (size_t)0), bool()) {
+  return true;
+}
+
+template <typename T>
+static bool supportsQueryFrames(T & /* wifi */, long) {
+  return false;
+}
+
+template <typename T>
+static auto supportsChangeQueries(T & wifi, int) -> decltype(wifi.iotReadChanges(*(uint32_t *)0, (uint8_t *)0, (size_t)0), bool()) {
+  return true;
+}
+
+template <typename T>
+static bool supportsChangeQueries(T & /* wifi */, long) {
+  return false;
+}
+
+template <typename T>
+static auto iotReadFrame(T & wifi, uint8_t const * query, size_t length, uint8_t * response, size_t size, int) -> decltype(wifi.iotReadProperties(query, length, response, size), size_t()) {
+  return wifi.iotReadProperties(query, length, response, size);
+}
+
+template <typename T>
+static size_t iotReadFrame(T & /* wifi */, uint8_t const * /* query */, size_t /* length */, uint8_t * /* response */, size_t /* size */, long) {
+  return 0;
+}
+
+template <typename T>
+static auto iotWriteFrame(T & wifi, uint8_t const * data, size_t length, int) -> decltype(wifi.iotWriteProperties(data, length), void()) {
+  wifi.iotWriteProperties(data, length);
+}
+
+template <typename T>
+static void iotWriteFrame(T & /* wifi */, uint8_t const * /* data */, size_t /* length */, long) {
+}
+
+template <typename T>
+static auto iotReadChanges(T & wifi, uint32_t & generation, uint8_t * changed, size_t size, int) -> decltype(wifi.iotReadChanges(generation, changed, size), bool()) {
+  return wifi.iotReadChanges(generation, changed, size);
+}
+
+template <typename T>
+static bool iotReadChanges(T & /* wifi */, uint32_t & /* generation */, uint8_t * /* changed */, size_t /* size */, long) {
+  return false;
+}
+
+/* WL_CONNECTED of the WiFiNINA status codes */
+static uint8_t const WIFI_LITE_CONNECTED = 3;
+
+template <typename T>
+static auto isConnected(T & wifi, int) -> decltype(wifi.status(), bool()) {
+  return wifi.status() == WIFI_LITE_CONNECTED;
+}
+
+template <typename T>
+static bool isConnected(T & /* wifi */, long) {
+  return true;
+}
+
+template <typename T>
+static auto iotWriteBool(T & wifi, char const * name, bool value, unsigned long timestamp, int) -> decltype(wifi.iotWritePropertyBool(name, value, timestamp), void()) {
+  wifi.iotWritePropertyBool(name, value, timestamp);
+}
+
+template <typename T>
+static void iotWriteBool(T & wifi, char const * name, bool value, unsigned long /* timestamp */, long) {
+  wifi.iotWritePropertyBool(name, value);
+}
+
+template <typename T>
+static auto iotWriteInt(T & wifi, char const * name, int value, unsigned long timestamp, int) -> decltype(wifi.iotWritePropertyInt(name, value, timestamp), void()) {
+  wifi.iotWritePropertyInt(name, value, timestamp);
+}
+
+template <typename T>
+static void iotWriteInt(T & wifi, char const * name, int value, unsigned long /* timestamp */, long) {
+  wifi.iotWritePropertyInt(name, value);
+}
+
+template <typename T>
+static auto iotWriteFloat(T & wifi, char const * name, float value, unsigned long timestamp, int) -> decltype(wifi.iotWritePropertyFloat(name, value, timestamp), void()) {
+  wifi.iotWritePropertyFloat(name, value, timestamp);
+}
+
+template <typename T>
+static void iotWriteFloat(T & wifi, char const * name, float value, unsigned long /* timestamp */, long) {
+  wifi.iotWritePropertyFloat(name, value);
+}
+
+template <typename T>
+static auto iotWriteString(T & wifi, char const * name, String const & value, unsigned long timestamp, int) -> decltype(wifi.iotWritePropertyString(name, value, timestamp), void()) {
+  wifi.iotWritePropertyString(name, value, timestamp);
+}
+
+template <typename T>
+static void iotWriteString(T & wifi, char const * name, String const & value, unsigned long /* timestamp */, long) {
+  wifi.iotWritePropertyString(name, value);
+}
+
+/******************************************************************************
+   GLOBAL VARIABLES
+ ******************************************************************************/
+
+ArduinoCloudTransportWiFiLite WiFiLiteTransport(WiFiLite);
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+ArduinoCloudTransportWiFiLite::ArduinoCloudTransportWiFiLite(WiFiLiteClass & wifi) :
+  _wifi(wifi)
+{}
+
+/* Defined here rather than with the rest of the Thing so that builds not linking this file, e.g. on a host, do not depend on WiFiLite */
+ArduinoCloudThingLite::ArduinoCloudThingLite() :
+  ArduinoCloudThingLite(WiFiLiteTransport)
+{}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void ArduinoCloudTransportWiFiLite::iotReadPropertyBool(char const * name, uint16_t const /* identifier */, bool & value, unsigned long & timestamp) {
+  _wifi.iotReadPropertyBool(name, &value, &timestamp);
+}
+
+void ArduinoCloudTransportWiFiLite::iotReadPropertyInt(char const * name, uint16_t const /* identifier */, int & value, unsigned long & timestamp) {
+  _wifi.iotReadPropertyInt(name, &value, &timestamp);
+}
+
+void ArduinoCloudTransportWiFiLite::iotReadPropertyFloat(char const * name, uint16_t const /* identifier */, float & value, unsigned long & timestamp) {
+  _wifi.iotReadPropertyFloat(name, &value, &timestamp);
+}
+
+void ArduinoCloudTransportWiFiLite::iotReadPropertyString(char const * name, uint16_t const /* identifier */, String & value, unsigned long & timestamp) {
+  _wifi.iotReadPropertyString(name, value, &timestamp);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyBool(char const * name, uint16_t const /* identifier */, bool const value) {
+  _wifi.iotWritePropertyBool(name, value);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyInt(char const * name, uint16_t const /* identifier */, int const value) {
+  _wifi.iotWritePropertyInt(name, value);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyFloat(char const * name, uint16_t const /* identifier */, float const value) {
+  _wifi.iotWritePropertyFloat(name, value);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyString(char const * name, uint16_t const /* identifier */, String const & value) {
+  _wifi.iotWritePropertyString(name, value);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyBool(char const * name, uint16_t const /* identifier */, bool const value, unsigned long const timestamp) {
+  iotWriteBool(_wifi, name, value, timestamp, 0);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyInt(char const * name, uint16_t const /* identifier */, int const value, unsigned long const timestamp) {
+  iotWriteInt(_wifi, name, value, timestamp, 0);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyFloat(char const * name, uint16_t const /* identifier */, float const value, unsigned long const timestamp) {
+  iotWriteFloat(_wifi, name, value, timestamp, 0);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWritePropertyString(char const * name, uint16_t const /* identifier */, String const & value, unsigned long const timestamp) {
+  iotWriteString(_wifi, name, value, timestamp, 0);
+}
+
+bool ArduinoCloudTransportWiFiLite::isConnected() {
+  return ::isConnected(_wifi, 0);
+}
+
+bool ArduinoCloudTransportWiFiLite::supportsFrames() {
+  return ::supportsFrames(_wifi, 0);
+}
+
+bool ArduinoCloudTransportWiFiLite::supportsQueryFrames() {
+  return ::supportsQueryFrames(_wifi, 0);
+}
+
+bool ArduinoCloudTransportWiFiLite::supportsChangeQueries() {
+  return ::supportsChangeQueries(_wifi, 0);
+}
+
+void ArduinoCloudTransportWiFiLite::iotWriteProperties(uint8_t const * frame, size_t const length) {
+  iotWriteFrame(_wifi, frame, length, 0);
+}
+
+size_t ArduinoCloudTransportWiFiLite::iotReadProperties(uint8_t const * query, size_t const length, uint8_t * response, size_t const size) {
+  return iotReadFrame(_wifi, query, length, response, size, 0);
+}
+
+bool ArduinoCloudTransportWiFiLite::iotReadChanges(uint32_t & generation, uint8_t * changed, size_t const size) {
+  return ::iotReadChanges(_wifi, generation, changed, size, 0);
+}
@@ -0,0 +1,83 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef ARDUINO_CLOUD_TRANSPORT_WIFI_LITE_H_
+#define ARDUINO_CLOUD_TRANSPORT_WIFI_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include <WiFiNINALite.h>
+
+#include "ArduinoCloudTransportLite.h"
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Transport over the WiFiLite API of the NINA module. Values are addressed by name only, identifiers are ignored.
+   Batched writes are used only if the WiFiLite in use exposes iotWriteProperties(uint8_t const * frame, size_t length).
+   WiFiNINALite does not expose it yet: until the module firmware provides it, every value written is a call of its own.
+   Batched reads are used only if it exposes iotReadProperties(uint8_t const * query, size_t length, uint8_t * response, size_t size).
+   WiFiNINALite does not expose it yet either: until the module firmware provides it, every value read is a call of its own.
+   Change queries are used only if it exposes bool iotReadChanges(uint32_t & generation, uint8_t * changed, size_t size).
+   WiFiNINALite does not expose iotReadChanges() yet: until the module firmware provides it, every read cycle reads all the properties.
+   The link is reported connected while status() is WL_CONNECTED, or always if the WiFiLite in use has no status(). Since status() is
+   an SPI command of its own, the Things read it once per cycle instead of before each exchange.
+   Values sent late from the offline queue carry their local change timestamp only if the WiFiLite in use exposes the writes
+   with a trailing unsigned long timestamp, e.g. iotWritePropertyInt(char const * name, int value, unsigned long timestamp) */
+class ArduinoCloudTransportWiFiLite : public ArduinoCloudTransportLite {
+  public:
+    ArduinoCloudTransportWiFiLite(WiFiLiteClass & wifi);
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp);
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp);
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp);
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp);
+
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value);
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp);
+
+    virtual bool isConnected();
+    virtual bool supportsFrames();
+    virtual bool supportsQueryFrames();
+    virtual bool supportsChangeQueries();
+    virtual void iotWriteProperties(uint8_t const * frame, size_t const length);
+    virtual size_t iotReadProperties(uint8_t const * query, size_t const length, uint8_t * response, size_t const size);
+    virtual bool iotReadChanges(uint32_t & generation, uint8_t * changed, size_t const size);
+
+  private:
+    WiFiLiteClass & _wifi;
+};
+
+/******************************************************************************
+   EXTERN
+ ******************************************************************************/
+
+extern WiFiLiteClass WiFiLite;
+/* Transport used by the default ArduinoCloudThingLite constructor */
+extern ArduinoCloudTransportWiFiLite WiFiLiteTransport;
+
+#endif /* ARDUINO_CLOUD_TRANSPORT_WIFI_LITE_H_ */
@@ -52,10 +52,10 @@ class CloudBool : public ArduinoCloudPropertyLite {
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void iotReadProperty() {
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_value);
     }
 
@@ -75,5 +75,7 @@ class CloudBool : public ArduinoCloudPropertyLite {
     //friends
 };
 
+static_assert(sizeof(CloudBool) <= cloudPropertySizeBudget(2 * sizeof(bool)), "CloudBool grew past its size budget");
+
 
 #endif /* CLOUDBOOL_H_ */
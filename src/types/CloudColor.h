@@ -23,14 +23,41 @@
  ******************************************************************************/
 
 #include <math.h>
+#include <string.h>
 #include <Arduino.h>
-#include "../ArduinoCloudProperty.h"
+#include "../ArduinoCloudPropertyLite.h"
 
 /******************************************************************************
    CLASS DECLARATION
  ******************************************************************************/
 
 class Color {
+    /* Component of each channel in the 6 sectors of the hue circle, 2 bits per sector starting from the lowest ones:
+       0 for none, 1 for the second component and 2 for the chroma */
+    static uint16_t const HUE_SECTOR_R = (2 << 0) | (1 << 2) | (0 << 4) | (0 << 6) | (1 << 8) | (2 << 10);
+    static uint16_t const HUE_SECTOR_G = (1 << 0) | (2 << 2) | (2 << 4) | (1 << 6) | (0 << 8) | (0 << 10);
+    static uint16_t const HUE_SECTOR_B = (0 << 0) | (0 << 2) | (1 << 4) | (2 << 6) | (2 << 8) | (1 << 10);
+
+    /* Q16 factors of getRGB(): 255 * 256 / 100, 65536 / 100 and 65536 / 60 */
+    static uint32_t const BRI_TO_LEVEL = (255ULL * 256 * 65536 + 50) / 100;
+    static uint32_t const SAT_TO_Q16   = (65536ULL * 65536 + 50) / 100;
+    static uint32_t const HUE_TO_Q16   = (65536ULL * 65536 + 30) / 60;
+
+    /* value * factor / 2^16 rounded to the nearest integer, factor being in Q16. Computed from the mantissa and the exponent of value,
+       without float arithmetic. value has to be within [0, 360] */
+    static uint32_t toFixed(float const value, uint32_t const factor) {
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      int const exponent = (bits >> 23) & 0xFF;
+      /* value is (mantissa * 2^(exponent - 150)), so the result is the product shifted right by (150 + 16 - exponent), at least 31 */
+      int const shift = 166 - exponent;
+      if (exponent == 0 || shift >= 64) {
+        return 0;
+      }
+      uint64_t const product = (uint64_t)((bits & 0x7FFFFF) | 0x800000) * factor;
+      return (uint32_t)((product + ((uint64_t)1 << (shift - 1))) >> shift);
+    }
+
   public:
     float hue, sat, bri;
     Color(float h, float s, float b): hue(h), sat(s), bri(b) {
@@ -51,7 +78,85 @@ class Color {
       return true;
     }
 
+    /* The conversions between RGB and HSB use integer arithmetic, the float kernels below being only used for the values out of
+       the range accepted by setColorHSB(). Compared to the float kernels, hue is within 0.0002 degrees, sat and bri within 0.00002
+       of their value, and each of R, G and B is within 1 of its value, off by 1 only when the exact value is within 0.01 of
+       a rounding boundary.
+       Define ARDUINO_CLOUD_COLOR_FLOAT to always use the float kernels */
     bool setColorRGB(uint8_t R, uint8_t G, uint8_t B) {
+#ifdef ARDUINO_CLOUD_COLOR_FLOAT
+      return setColorRGBFloat(R, G, B);
+#else
+      uint8_t max = R,
+              min = R,
+              imax = 0;
+      /* Ties go to the last channel, as in setColorRGBFloat() */
+      if (G >= max) {
+        max = G;
+        imax = 1;
+      }
+      if (B >= max) {
+        max = B;
+        imax = 2;
+      }
+      if (G < min) {
+        min = G;
+      }
+      if (B < min) {
+        min = B;
+      }
+
+      uint32_t const delta = max - min;
+      if (delta == 0) {
+        hue = 0;
+      } else {
+        /* 60 * (sector + diff / delta) degrees, the sector starting at 0, 120 or 240 degrees */
+        int32_t const diff = (imax == 0) ? (G - B) : ((imax == 1) ? (B - R) : (R - G));
+        int32_t degrees = (120 * imax) * (int32_t)delta + 60 * diff;
+        if (degrees < 0) {
+          degrees += 360 * (int32_t)delta;
+        }
+        /* Q14, at most 360 * 255 * 2^14 */
+        hue = ((((uint32_t)degrees << 14) + delta / 2) / delta) * (1.0f / 16384.0f);
+      }
+
+      /* Q16, at most 100 * 255 * 2^16 */
+      sat = (max == 0) ? 0 : (((((uint32_t)delta * 100) << 16) + max / 2) / max) * (1.0f / 65536.0f);
+      bri = (((((uint32_t)max * 100) << 16) + 127) / 255) * (1.0f / 65536.0f);
+      return true;
+#endif
+    }
+
+    void getRGB(uint8_t& R, uint8_t& G, uint8_t& B) {
+#ifdef ARDUINO_CLOUD_COLOR_FLOAT
+      getRGBFloat(R, G, B);
+#else
+      if (!(hue >= 0 && hue <= 360 && sat >= 0 && sat <= 100 && bri >= 0 && bri <= 100)) {
+        getRGBFloat(R, G, B);
+        return;
+      }
+      /* Levels in 1/256 of a channel step, at most 255 * 2^8, saturation and position in the hue sector in Q16 */
+      uint32_t const v = toFixed(bri, BRI_TO_LEVEL);
+      uint32_t const s = toFixed(sat, SAT_TO_Q16);
+      uint32_t const h = toFixed(hue, HUE_TO_Q16);
+      uint32_t const c = (v * s) >> 16;
+      uint32_t sector = h >> 16;
+      uint32_t const f = h & 0xFFFF;
+      if (sector >= 6) {
+        sector -= 6;
+      }
+      /* The second component rises in the even sectors and falls in the odd ones */
+      uint32_t const x = (c * ((sector & 1) ? (65536 - f) : f)) >> 16;
+      uint32_t const m = v - c;
+      uint32_t const level[3] = { m, x + m, c + m };
+      R = (level[(HUE_SECTOR_R >> (2 * sector)) & 3] + 128) >> 8;
+      G = (level[(HUE_SECTOR_G >> (2 * sector)) & 3] + 128) >> 8;
+      B = (level[(HUE_SECTOR_B >> (2 * sector)) & 3] + 128) >> 8;
+#endif
+    }
+
+    /* Reference floating point kernels */
+    bool setColorRGBFloat(uint8_t R, uint8_t G, uint8_t B) {
       float temp[3];
       float max, min, delta;
       uint8_t imax;
@@ -79,6 +184,10 @@ class Color {
       } else if (imax == 0) {
 
         hue = 60 * fmod((temp[1] - temp[2]) / delta, 6);
+        /* fmod() keeps the sign of the dividend, bring red hues leaning to blue back to [0, 360) */
+        if (hue < 0) {
+          hue += 360;
+        }
       } else if (imax == 1) {
         hue = 60 * (((temp[2] - temp[0]) / delta) + 2);
       } else if (imax == 2) {
@@ -95,7 +204,7 @@ class Color {
       return true;
     }
 
-    void getRGB(uint8_t& R, uint8_t& G, uint8_t& B) {
+    void getRGBFloat(uint8_t& R, uint8_t& G, uint8_t& B) {
       float fC = (bri / 100) * (sat / 100);
       float fHPrime = fmod(hue / 60.0, 6);
       float fX = fC * (1 - fabs(fmod(fHPrime, 2) - 1));
@@ -153,7 +262,7 @@ class Color {
 
 };
 
-class CloudColor : public ArduinoCloudProperty {
+class CloudColor : public ArduinoCloudPropertyLite {
   private:
     Color _value,
           _cloud_value;
@@ -183,21 +292,31 @@ class CloudColor : public ArduinoCloudProperty {
     }
 
     virtual void fromCloudToLocal() {
-      _value = _cloud_value;
+      if (isAttributeChangedByCloud(0)) {
+        _value.hue = _cloud_value.hue;
+      }
+      if (isAttributeChangedByCloud(1)) {
+        _value.sat = _cloud_value.sat;
+      }
+      if (isAttributeChangedByCloud(2)) {
+        _value.bri = _cloud_value.bri;
+      }
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void appendAttributesToCloud() {
-      appendAttribute(_value.hue);
-      appendAttribute(_value.sat);
-      appendAttribute(_value.bri);
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
+      readProperty(_cloud_value.hue);
+      readProperty(_cloud_value.sat);
+      readProperty(_cloud_value.bri);
     }
-    virtual void setAttributesFromCloud() {
-      setAttribute(_cloud_value.hue);
-      setAttribute(_cloud_value.sat);
-      setAttribute(_cloud_value.bri);
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
+      writeAttribute(_value.hue, _cloud_value.hue);
+      writeAttribute(_value.sat, _cloud_value.sat);
+      writeAttribute(_value.bri, _cloud_value.bri);
     }
 };
 
+static_assert(sizeof(CloudColor) <= cloudPropertySizeBudget(2 * sizeof(Color)), "CloudColor grew past its size budget");
+
 #endif /* CLOUDCOLOR_H_ */
\ No newline at end of file
@@ -0,0 +1,105 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef CLOUDFIXEDSTRING_H_
+#define CLOUDFIXEDSTRING_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include <string.h>
+#include "../ArduinoCloudPropertyLite.h"
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* String property of at most CAPACITY characters, longer values are truncated. The value and its cloud shadow are stored
+   inline as length-prefixed, '\0' terminated buffers, so that neither assignments nor synchronization allocate memory */
+template <size_t CAPACITY>
+class CloudFixedString : public ArduinoCloudPropertyLite {
+    static_assert(CAPACITY > 0 && CAPACITY < 254, "CloudFixedString: CAPACITY must be between 1 and 253");
+
+  private:
+    uint8_t _value[CAPACITY + 2],
+            _cloud_value[CAPACITY + 2];
+
+    static void assign(uint8_t * buffer, char const * v, size_t const length) {
+      size_t const n = (length > CAPACITY) ? CAPACITY : length;
+      buffer[0] = n;
+      memcpy(&buffer[1], v, n);
+      buffer[1 + n] = '\0';
+    }
+  public:
+    CloudFixedString() {
+      assign(_value, "", 0);
+      assign(_cloud_value, "", 0);
+    }
+    CloudFixedString(char const * v) {
+      assign(_value, v, strlen(v));
+      assign(_cloud_value, v, strlen(v));
+    }
+    inline char const * c_str() const {
+      return reinterpret_cast<char const *>(&_value[1]);
+    }
+    inline size_t length() const {
+      return _value[0];
+    }
+    inline size_t capacity() const {
+      return CAPACITY;
+    }
+    virtual bool isDifferentFromCloud() {
+      return memcmp(_value, _cloud_value, 1 + _value[0]) != 0;
+    }
+    virtual void fromCloudToLocal() {
+      memcpy(_value, _cloud_value, 2 + _cloud_value[0]);
+    }
+    virtual void fromLocalToCloud() {
+      memcpy(_cloud_value, _value, 2 + _value[0]);
+    }
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
+      readProperty(_cloud_value);
+    }
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
+      writeProperty(_value);
+    }
+    //modifiers
+    CloudFixedString& operator=(char const * v) {
+      assign(_value, v, strlen(v));
+      updateLocalTimestamp();
+      return *this;
+    }
+    CloudFixedString& operator=(String const & v) {
+      assign(_value, v.c_str(), v.length());
+      updateLocalTimestamp();
+      return *this;
+    }
+    bool operator==(char const * c) const {
+      size_t const n = strlen(c);
+      return n == _value[0] && memcmp(&_value[1], c, n) == 0;
+    }
+    bool operator!=(char const * c) const {
+      return !operator==(c);
+    }
+};
+
+static_assert(sizeof(CloudFixedString<1>) <= cloudPropertySizeBudget(2 * (1 + 2)), "CloudFixedString grew past its size budget");
+
+
+#endif /* CLOUDFIXEDSTRING_H_ */
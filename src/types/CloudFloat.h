@@ -46,7 +46,7 @@ class CloudFloat : public ArduinoCloudPropertyLite {
       return _value;
     }
     virtual bool isDifferentFromCloud() {
-      return _value != _cloud_value && (abs(_value - _cloud_value) >= ArduinoCloudPropertyLite::_min_delta_property);
+      return _value != _cloud_value && (abs(_value - _cloud_value) >= minDelta());
     }
     virtual void fromCloudToLocal() {
       _value = _cloud_value;
@@ -54,10 +54,10 @@ class CloudFloat : public ArduinoCloudPropertyLite {
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void iotReadProperty() {
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_value);
     }
     //modifiers
@@ -96,92 +96,94 @@ class CloudFloat : public ArduinoCloudPropertyLite {
       return CloudFloat(_value);
     }
 
-    //friends
-    friend CloudFloat operator+(CloudFloat iw, CloudFloat v) {
-      return iw += v;
+    //friends, on the plain values: a copy of a registered property would mark the slot of the original dirty
+    friend float operator+(CloudFloat const & iw, CloudFloat const & v) {
+      return iw._value + v._value;
     }
-    friend CloudFloat operator+(CloudFloat iw, float v) {
-      return iw += v;
+    friend float operator+(CloudFloat const & iw, float v) {
+      return iw._value + v;
     }
-    friend CloudFloat operator+(CloudFloat iw, int v) {
-      return iw += (float)v;
+    friend float operator+(CloudFloat const & iw, int v) {
+      return iw._value + v;
     }
-    friend CloudFloat operator+(CloudFloat iw, double v) {
-      return iw += (float)v;
+    friend float operator+(CloudFloat const & iw, double v) {
+      return iw._value + static_cast<float>(v);
     }
-    friend CloudFloat operator+(float v, CloudFloat iw) {
-      return CloudFloat(v) += iw;
+    friend float operator+(float v, CloudFloat const & iw) {
+      return v + iw._value;
     }
-    friend CloudFloat operator+(int v, CloudFloat iw) {
-      return CloudFloat(v) += iw;
+    friend float operator+(int v, CloudFloat const & iw) {
+      return v + iw._value;
     }
-    friend CloudFloat operator+(double v, CloudFloat iw) {
-      return CloudFloat(v) += iw;
+    friend float operator+(double v, CloudFloat const & iw) {
+      return static_cast<float>(v) + iw._value;
     }
-    friend CloudFloat operator-(CloudFloat iw, CloudFloat v) {
-      return iw -= v;
+    friend float operator-(CloudFloat const & iw, CloudFloat const & v) {
+      return iw._value - v._value;
     }
-    friend CloudFloat operator-(CloudFloat iw, float v) {
-      return iw -= v;
+    friend float operator-(CloudFloat const & iw, float v) {
+      return iw._value - v;
     }
-    friend CloudFloat operator-(CloudFloat iw, int v) {
-      return iw -= (float)v;
+    friend float operator-(CloudFloat const & iw, int v) {
+      return iw._value - v;
     }
-    friend CloudFloat operator-(CloudFloat iw, double v) {
-      return iw -= (float)v;
+    friend float operator-(CloudFloat const & iw, double v) {
+      return iw._value - static_cast<float>(v);
     }
-    friend CloudFloat operator-(float v, CloudFloat iw) {
-      return CloudFloat(v) -= iw;
+    friend float operator-(float v, CloudFloat const & iw) {
+      return v - iw._value;
     }
-    friend CloudFloat operator-(int v, CloudFloat iw) {
-      return CloudFloat(v) -= iw;
+    friend float operator-(int v, CloudFloat const & iw) {
+      return v - iw._value;
     }
-    friend CloudFloat operator-(double v, CloudFloat iw) {
-      return CloudFloat(v) -= iw;
+    friend float operator-(double v, CloudFloat const & iw) {
+      return static_cast<float>(v) - iw._value;
     }
-    friend CloudFloat operator*(CloudFloat iw, CloudFloat v) {
-      return iw *= v;
+    friend float operator*(CloudFloat const & iw, CloudFloat const & v) {
+      return iw._value * v._value;
     }
-    friend CloudFloat operator*(CloudFloat iw, float v) {
-      return iw *= v;
+    friend float operator*(CloudFloat const & iw, float v) {
+      return iw._value * v;
     }
-    friend CloudFloat operator*(CloudFloat iw, int v) {
-      return iw *= (float)v;
+    friend float operator*(CloudFloat const & iw, int v) {
+      return iw._value * v;
     }
-    friend CloudFloat operator*(CloudFloat iw, double v) {
-      return iw *= (float)v;
+    friend float operator*(CloudFloat const & iw, double v) {
+      return iw._value * static_cast<float>(v);
     }
-    friend CloudFloat operator*(float v, CloudFloat iw) {
-      return CloudFloat(v) *= iw;
+    friend float operator*(float v, CloudFloat const & iw) {
+      return v * iw._value;
     }
-    friend CloudFloat operator*(int v, CloudFloat iw) {
-      return CloudFloat(v) *= iw;
+    friend float operator*(int v, CloudFloat const & iw) {
+      return v * iw._value;
     }
-    friend CloudFloat operator*(double v, CloudFloat iw) {
-      return CloudFloat(v) *= iw;
+    friend float operator*(double v, CloudFloat const & iw) {
+      return static_cast<float>(v) * iw._value;
     }
-    friend CloudFloat operator/(CloudFloat iw, CloudFloat v) {
-      return iw /= v;
+    friend float operator/(CloudFloat const & iw, CloudFloat const & v) {
+      return iw._value / v._value;
     }
-    friend CloudFloat operator/(CloudFloat iw, float v) {
-      return iw /= v;
+    friend float operator/(CloudFloat const & iw, float v) {
+      return iw._value / v;
     }
-    friend CloudFloat operator/(CloudFloat iw, int v) {
-      return iw /= (float)v;
+    friend float operator/(CloudFloat const & iw, int v) {
+      return iw._value / v;
     }
-    friend CloudFloat operator/(CloudFloat iw, double v) {
-      return iw /= (float)v;
+    friend float operator/(CloudFloat const & iw, double v) {
+      return iw._value / static_cast<float>(v);
     }
-    friend CloudFloat operator/(float v, CloudFloat iw) {
-      return CloudFloat(v) /= iw;
+    friend float operator/(float v, CloudFloat const & iw) {
+      return v / iw._value;
     }
-    friend CloudFloat operator/(int v, CloudFloat iw) {
-      return CloudFloat(v) /= iw;
+    friend float operator/(int v, CloudFloat const & iw) {
+      return v / iw._value;
     }
-    friend CloudFloat operator/(double v, CloudFloat iw) {
-      return CloudFloat(v) /= iw;
+    friend float operator/(double v, CloudFloat const & iw) {
+      return static_cast<float>(v) / iw._value;
     }
 };
 
+static_assert(sizeof(CloudFloat) <= cloudPropertySizeBudget(2 * sizeof(float)), "CloudFloat grew past its size budget");
+
 
 #endif /* CLOUDFLOAT_H_ */
@@ -44,7 +44,7 @@ class CloudInt : public ArduinoCloudPropertyLite {
       return _value;
     }
     virtual bool isDifferentFromCloud() {
-      return _value != _cloud_value && (abs(_value - _cloud_value) >= ArduinoCloudPropertyLite::_min_delta_property);
+      return _value != _cloud_value && (abs(_value - _cloud_value) >= minDelta());
     }
     virtual void fromCloudToLocal() {
       _value = _cloud_value;
@@ -52,10 +52,10 @@ class CloudInt : public ArduinoCloudPropertyLite {
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void iotReadProperty() {
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_value);
     }
     //modifiers
@@ -124,99 +124,101 @@ class CloudInt : public ArduinoCloudPropertyLite {
     CloudInt operator~() const {
       return CloudInt(~_value);
     }
-    //friends
-    friend CloudInt operator+(CloudInt iw, CloudInt v) {
-      return iw += v;
+    //friends, on the plain values: a copy of a registered property would mark the slot of the original dirty
+    friend int operator+(CloudInt const & iw, CloudInt const & v) {
+      return iw._value + v._value;
     }
-    friend CloudInt operator+(CloudInt iw, int v) {
-      return iw += v;
+    friend int operator+(CloudInt const & iw, int v) {
+      return iw._value + v;
     }
-    friend CloudInt operator+(int v, CloudInt iw) {
-      return CloudInt(v) += iw;
+    friend int operator+(int v, CloudInt const & iw) {
+      return v + iw._value;
     }
-    friend CloudInt operator-(CloudInt iw, CloudInt v) {
-      return iw -= v;
+    friend int operator-(CloudInt const & iw, CloudInt const & v) {
+      return iw._value - v._value;
     }
-    friend CloudInt operator-(CloudInt iw, int v) {
-      return iw -= v;
+    friend int operator-(CloudInt const & iw, int v) {
+      return iw._value - v;
     }
-    friend CloudInt operator-(int v, CloudInt iw) {
-      return CloudInt(v) -= iw;
+    friend int operator-(int v, CloudInt const & iw) {
+      return v - iw._value;
     }
-    friend CloudInt operator*(CloudInt iw, CloudInt v) {
-      return iw *= v;
+    friend int operator*(CloudInt const & iw, CloudInt const & v) {
+      return iw._value * v._value;
     }
-    friend CloudInt operator*(CloudInt iw, int v) {
-      return iw *= v;
+    friend int operator*(CloudInt const & iw, int v) {
+      return iw._value * v;
     }
-    friend CloudInt operator*(int v, CloudInt iw) {
-      return CloudInt(v) *= iw;
+    friend int operator*(int v, CloudInt const & iw) {
+      return v * iw._value;
     }
-    friend CloudInt operator/(CloudInt iw, CloudInt v) {
-      return iw /= v;
+    friend int operator/(CloudInt const & iw, CloudInt const & v) {
+      return iw._value / v._value;
     }
-    friend CloudInt operator/(CloudInt iw, int v) {
-      return iw /= v;
+    friend int operator/(CloudInt const & iw, int v) {
+      return iw._value / v;
     }
-    friend CloudInt operator/(int v, CloudInt iw) {
-      return CloudInt(v) /= iw;
+    friend int operator/(int v, CloudInt const & iw) {
+      return v / iw._value;
     }
-    friend CloudInt operator%(CloudInt iw, CloudInt v) {
-      return iw %= v;
+    friend int operator%(CloudInt const & iw, CloudInt const & v) {
+      return iw._value % v._value;
     }
-    friend CloudInt operator%(CloudInt iw, int v) {
-      return iw %= v;
+    friend int operator%(CloudInt const & iw, int v) {
+      return iw._value % v;
     }
-    friend CloudInt operator%(int v, CloudInt iw) {
-      return CloudInt(v) %= iw;
+    friend int operator%(int v, CloudInt const & iw) {
+      return v % iw._value;
     }
-    friend CloudInt operator&(CloudInt iw, CloudInt v) {
-      return iw &= v;
+    friend int operator&(CloudInt const & iw, CloudInt const & v) {
+      return iw._value & v._value;
     }
-    friend CloudInt operator&(CloudInt iw, int v) {
-      return iw &= v;
+    friend int operator&(CloudInt const & iw, int v) {
+      return iw._value & v;
     }
-    friend CloudInt operator&(int v, CloudInt iw) {
-      return CloudInt(v) &= iw;
+    friend int operator&(int v, CloudInt const & iw) {
+      return v & iw._value;
     }
-    friend CloudInt operator|(CloudInt iw, CloudInt v) {
-      return iw |= v;
+    friend int operator|(CloudInt const & iw, CloudInt const & v) {
+      return iw._value | v._value;
     }
-    friend CloudInt operator|(CloudInt iw, int v) {
-      return iw |= v;
+    friend int operator|(CloudInt const & iw, int v) {
+      return iw._value | v;
     }
-    friend CloudInt operator|(int v, CloudInt iw) {
-      return CloudInt(v) |= iw;
+    friend int operator|(int v, CloudInt const & iw) {
+      return v | iw._value;
     }
-    friend CloudInt operator^(CloudInt iw, CloudInt v) {
-      return iw ^= v;
+    friend int operator^(CloudInt const & iw, CloudInt const & v) {
+      return iw._value ^ v._value;
     }
-    friend CloudInt operator^(CloudInt iw, int v) {
-      return iw ^= v;
+    friend int operator^(CloudInt const & iw, int v) {
+      return iw._value ^ v;
     }
-    friend CloudInt operator^(int v, CloudInt iw) {
-      return CloudInt(v) ^= iw;
+    friend int operator^(int v, CloudInt const & iw) {
+      return v ^ iw._value;
     }
-    friend CloudInt operator<<(CloudInt iw, CloudInt v) {
-      return iw <<= v;
+    friend int operator<<(CloudInt const & iw, CloudInt const & v) {
+      return iw._value << v._value;
     }
-    friend CloudInt operator<<(CloudInt iw, int v) {
-      return iw <<= v;
+    friend int operator<<(CloudInt const & iw, int v) {
+      return iw._value << v;
     }
-    friend CloudInt operator<<(int v, CloudInt iw) {
-      return CloudInt(v) <<= iw;
+    friend int operator<<(int v, CloudInt const & iw) {
+      return v << iw._value;
     }
-    friend CloudInt operator>>(CloudInt iw, CloudInt v) {
-      return iw >>= v;
+    friend int operator>>(CloudInt const & iw, CloudInt const & v) {
+      return iw._value >> v._value;
     }
-    friend CloudInt operator>>(CloudInt iw, int v) {
-      return iw >>= v;
+    friend int operator>>(CloudInt const & iw, int v) {
+      return iw._value >> v;
     }
-    friend CloudInt operator>>(int v, CloudInt iw) {
-      return CloudInt(v) >>= iw;
+    friend int operator>>(int v, CloudInt const & iw) {
+      return v >> iw._value;
     }
 
 };
 
+static_assert(sizeof(CloudInt) <= cloudPropertySizeBudget(2 * sizeof(int)), "CloudInt grew past its size budget");
+
 
 #endif /* CLOUDINT_H_ */
@@ -24,7 +24,7 @@
 
 #include <math.h>
 #include <Arduino.h>
-#include "../ArduinoCloudProperty.h"
+#include "../ArduinoCloudPropertyLite.h"
 
 /******************************************************************************
    CLASS DECLARATION
@@ -56,7 +56,7 @@ class Location {
     }
 };
 
-class CloudLocation : public ArduinoCloudProperty {
+class CloudLocation : public ArduinoCloudPropertyLite {
   private:
     Location _value,
              _cloud_value;
@@ -65,7 +65,7 @@ class CloudLocation : public ArduinoCloudProperty {
     CloudLocation(float lat, float lon) : _value(lat, lon), _cloud_value(lat, lon) {}
     virtual bool isDifferentFromCloud() {
       float const distance = Location::distance(_value, _cloud_value);
-      return _value != _cloud_value && (abs(distance) >= ArduinoCloudProperty::_min_delta_property);
+      return _value != _cloud_value && (abs(distance) >= minDelta());
     }
 
     CloudLocation& operator=(Location aLocation) {
@@ -84,19 +84,26 @@ class CloudLocation : public ArduinoCloudProperty {
     }
 
     virtual void fromCloudToLocal() {
-      _value = _cloud_value;
+      if (isAttributeChangedByCloud(0)) {
+        _value.lat = _cloud_value.lat;
+      }
+      if (isAttributeChangedByCloud(1)) {
+        _value.lon = _cloud_value.lon;
+      }
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void appendAttributesToCloud() {
-      appendAttribute(_value.lat);
-      appendAttribute(_value.lon);
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
+      readProperty(_cloud_value.lat);
+      readProperty(_cloud_value.lon);
     }
-    virtual void setAttributesFromCloud() {
-      setAttribute(_cloud_value.lat);
-      setAttribute(_cloud_value.lon);
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
+      writeAttribute(_value.lat, _cloud_value.lat);
+      writeAttribute(_value.lon, _cloud_value.lon);
     }
 };
 
+static_assert(sizeof(CloudLocation) <= cloudPropertySizeBudget(2 * sizeof(Location)), "CloudLocation grew past its size budget");
+
 #endif /* CLOUDLOCATION_H_ */
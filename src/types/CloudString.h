@@ -55,10 +55,10 @@ class CloudString : public ArduinoCloudPropertyLite {
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void iotReadProperty() {
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_value);
     }
     //modifiers
@@ -85,5 +85,7 @@ class CloudString : public ArduinoCloudPropertyLite {
     }
 };
 
+static_assert(sizeof(CloudString) <= cloudPropertySizeBudget(2 * sizeof(String)), "CloudString grew past its size budget");
+
 
 #endif /* CLOUDSTRING_H_ */
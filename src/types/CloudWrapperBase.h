@@ -29,10 +29,12 @@
    CLASS DECLARATION
  ******************************************************************************/
 
+/* Wrappers are not notified of the changes of the variable they wrap: a snapshot of the variable is compared to its current value.
+   The snapshot is taken again once a change has been handled, and when the value comes from the cloud */
 class CloudWrapperBase : public ArduinoCloudPropertyLite {
   public:
     virtual bool isChangedLocally() = 0;
-    
+    virtual void takeLocalSnapshot() = 0;
 };
 
 
@@ -41,6 +41,7 @@ class CloudWrapperBool : public CloudWrapperBase {
     }
     virtual void fromCloudToLocal() {
       _primitive_value = _cloud_value;
+      _local_value = _cloud_value;
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _primitive_value;
@@ -51,13 +52,18 @@ class CloudWrapperBool : public CloudWrapperBase {
     virtual bool isChangedLocally() {
       return _primitive_value != _local_value;
     }
-    virtual void iotReadProperty() {
+    virtual void takeLocalSnapshot() {
+      _local_value = _primitive_value;
+    }
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_primitive_value);
     }
 };
 
+static_assert(sizeof(CloudWrapperBool) <= cloudPropertySizeBudget(sizeof(bool *) + 2 * sizeof(bool)), "CloudWrapperBool grew past its size budget");
+
 
 #endif /* CLOUDWRAPPERBOOL_H_ */
@@ -37,10 +37,11 @@ class CloudWrapperInt : public CloudWrapperBase {
   public:
     CloudWrapperInt(int& v) : _primitive_value(v), _cloud_value(v), _local_value(v) {}
     virtual bool isDifferentFromCloud() {
-      return _primitive_value != _cloud_value && (abs(_primitive_value - _cloud_value) >= ArduinoCloudPropertyLite::_min_delta_property);
+      return _primitive_value != _cloud_value && (abs(_primitive_value - _cloud_value) >= minDelta());
     }
     virtual void fromCloudToLocal() {
       _primitive_value = _cloud_value;
+      _local_value = _cloud_value;
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _primitive_value;
@@ -51,13 +52,18 @@ class CloudWrapperInt : public CloudWrapperBase {
     virtual bool isChangedLocally() {
       return _primitive_value != _local_value;
     }
-    virtual void iotReadProperty() {
+    virtual void takeLocalSnapshot() {
+      _local_value = _primitive_value;
+    }
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_primitive_value);
     }
 };
 
+static_assert(sizeof(CloudWrapperInt) <= cloudPropertySizeBudget(sizeof(int *) + 2 * sizeof(int)), "CloudWrapperInt grew past its size budget");
+
 
 #endif /* CLOUDWRAPPERINT_H_ */
@@ -45,6 +45,7 @@ class CloudWrapperString : public CloudWrapperBase {
     }
     virtual void fromCloudToLocal() {
       _primitive_value = _cloud_value;
+      _local_value = _cloud_value;
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _primitive_value;
@@ -52,16 +53,22 @@ class CloudWrapperString : public CloudWrapperBase {
     virtual bool isPrimitive() {
       return true;
     }
+    /* String compares the lengths first, the characters are only compared when they are equal */
     virtual bool isChangedLocally() {
       return _primitive_value != _local_value;
     }
-    virtual void iotReadProperty() {
+    virtual void takeLocalSnapshot() {
+      _local_value = _primitive_value;
+    }
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
       readProperty(_cloud_value);
     }
-    virtual void iotWriteProperty() {
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
       writeProperty(_primitive_value);
     }
 };
 
+static_assert(sizeof(CloudWrapperString) <= cloudPropertySizeBudget(sizeof(String *) + 2 * sizeof(String)), "CloudWrapperString grew past its size budget");
+
 
 #endif /* CLOUDWRAPPERSTRING_H_ */
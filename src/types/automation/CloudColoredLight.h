@@ -82,6 +82,7 @@ class CloudColoredLight : public CloudColor {
 
     void setSwitch(bool const swi) {
       _value.swi = swi;
+      markDirty();
     }
 
     float getHue() {
@@ -90,6 +91,7 @@ class CloudColoredLight : public CloudColor {
 
     void setHue(float const hue) {
       _value.hue = hue;
+      markDirty();
     }
 
     float getSaturation() {
@@ -98,6 +100,7 @@ class CloudColoredLight : public CloudColor {
 
     void setSaturation(float const sat) {
       _value.sat = sat;
+      markDirty();
     }
 
     float getBrightness() {
@@ -106,26 +109,40 @@ class CloudColoredLight : public CloudColor {
 
     void setBrightness(float const bri) {
       _value.bri = bri;
+      markDirty();
     }
 
     virtual void fromCloudToLocal() {
-      _value = _cloud_value;
+      if (isAttributeChangedByCloud(0)) {
+        _value.swi = _cloud_value.swi;
+      }
+      if (isAttributeChangedByCloud(1)) {
+        _value.hue = _cloud_value.hue;
+      }
+      if (isAttributeChangedByCloud(2)) {
+        _value.sat = _cloud_value.sat;
+      }
+      if (isAttributeChangedByCloud(3)) {
+        _value.bri = _cloud_value.bri;
+      }
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void appendAttributesToCloud() {
-      appendAttribute(_value.swi);
-      appendAttribute(_value.hue);
-      appendAttribute(_value.sat);
-      appendAttribute(_value.bri);
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
+      readProperty(_cloud_value.swi);
+      readProperty(_cloud_value.hue);
+      readProperty(_cloud_value.sat);
+      readProperty(_cloud_value.bri);
     }
-    virtual void setAttributesFromCloud() {
-      setAttribute(_cloud_value.swi);
-      setAttribute(_cloud_value.hue);
-      setAttribute(_cloud_value.sat);
-      setAttribute(_cloud_value.bri);
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
+      writeAttribute(_value.swi, _cloud_value.swi);
+      writeAttribute(_value.hue, _cloud_value.hue);
+      writeAttribute(_value.sat, _cloud_value.sat);
+      writeAttribute(_value.bri, _cloud_value.bri);
     }
 };
 
+static_assert(sizeof(CloudColoredLight) <= cloudPropertySizeBudget(2 * sizeof(Color) + 2 * sizeof(ColoredLight)), "CloudColoredLight grew past its size budget");
+
 #endif /* CLOUDCOLOREDLIGHT_H_ */
\ No newline at end of file
@@ -24,7 +24,7 @@
 
 #include <math.h>
 #include <Arduino.h>
-#include "../../ArduinoCloudProperty.h"
+#include "../../ArduinoCloudPropertyLite.h"
 
 /******************************************************************************
    CLASS DECLARATION
@@ -46,7 +46,7 @@ class DimmedLight {
 
 };
 
-class CloudDimmedLight : public ArduinoCloudProperty {
+class CloudDimmedLight : public ArduinoCloudPropertyLite {
   private:
     DimmedLight _value,
                 _cloud_value;
@@ -81,6 +81,7 @@ class CloudDimmedLight : public ArduinoCloudProperty {
 
     void setBrightness(float const bri) {
       _value.bri = bri;
+      markDirty();
     }
 
     bool getSwitch() {
@@ -89,33 +90,40 @@ class CloudDimmedLight : public ArduinoCloudProperty {
 
     void setSwitch(bool const swi) {
       _value.swi = swi;
+      markDirty();
     }
 
     virtual void fromCloudToLocal() {
-      _value = _cloud_value;
+      if (isAttributeChangedByCloud(0)) {
+        _value.swi = _cloud_value.swi;
+      }
+      if (isAttributeChangedByCloud(1)) {
+        _value.bri = _cloud_value.bri;
+      }
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
 
-    virtual void appendAttributesToCloud() {
-      appendAttribute(_value.swi);
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
+      readProperty(_cloud_value.swi);
+      readProperty(_cloud_value.bri);
+    }
+
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
+      writeAttribute(_value.swi, _cloud_value.swi);
+      writeAttribute(_value.bri, _cloud_value.bri);
       // To allow visualization through color widget
       // Start
+      // Written after bri, so that swi and bri get the same attribute identifiers as in iotReadProperty()
       float hue = 0;
       float sat = 0;
-      appendAttributeReal(hue, getAttributeName(".hue", '.'), encoder);
-      appendAttributeReal(sat, getAttributeName(".sat", '.'), encoder);
-      appendAttribute(_value.bri);
-      // should be only:
-      // appendAttribute(_value.bri);
+      iotWriteAttributeReal(hue, hue, "hue", transport);
+      iotWriteAttributeReal(sat, sat, "sat", transport);
       // end
     }
-
-    virtual void setAttributesFromCloud() {
-      setAttribute(_cloud_value.swi);
-      setAttribute(_cloud_value.bri);
-    }
 };
 
+static_assert(sizeof(CloudDimmedLight) <= cloudPropertySizeBudget(2 * sizeof(DimmedLight)), "CloudDimmedLight grew past its size budget");
+
 #endif /* CLOUDDIMMEDLIGHT_H_ */
\ No newline at end of file
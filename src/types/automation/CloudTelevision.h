@@ -23,7 +23,7 @@
  ******************************************************************************/
 
 #include <Arduino.h>
-#include "../../ArduinoCloudProperty.h"
+#include "../../ArduinoCloudPropertyLite.h"
 
 /******************************************************************************
    ENUM
@@ -136,7 +136,7 @@ class Television {
 
 };
 
-class CloudTelevision : public ArduinoCloudProperty {
+class CloudTelevision : public ArduinoCloudPropertyLite {
   private:
     Television _value,
                _cloud_value;
@@ -193,27 +193,46 @@ class CloudTelevision : public ArduinoCloudProperty {
     }
 
     virtual void fromCloudToLocal() {
-      _value = _cloud_value;
+      if (isAttributeChangedByCloud(0)) {
+        _value.swi = _cloud_value.swi;
+      }
+      if (isAttributeChangedByCloud(1)) {
+        _value.vol = _cloud_value.vol;
+      }
+      if (isAttributeChangedByCloud(2)) {
+        _value.mut = _cloud_value.mut;
+      }
+      if (isAttributeChangedByCloud(3)) {
+        _value.pbc = _cloud_value.pbc;
+      }
+      if (isAttributeChangedByCloud(4)) {
+        _value.inp = _cloud_value.inp;
+      }
+      if (isAttributeChangedByCloud(5)) {
+        _value.cha = _cloud_value.cha;
+      }
     }
     virtual void fromLocalToCloud() {
       _cloud_value = _value;
     }
-    virtual void appendAttributesToCloud() {
-      appendAttribute(_value.swi);
-      appendAttribute(_value.vol);
-      appendAttribute(_value.mut);
-      appendAttribute((int)_value.pbc);
-      appendAttribute((int)_value.inp);
-      appendAttribute(_value.cha);
-    }
-    virtual void setAttributesFromCloud() {
-      setAttribute(_cloud_value.swi);
-      setAttribute(_cloud_value.vol);
-      setAttribute(_cloud_value.mut);
-      setAttribute((int&)_cloud_value.pbc);
-      setAttribute((int&)_cloud_value.inp);
-      setAttribute(_cloud_value.cha);
+    virtual void iotReadProperty(ArduinoCloudTransportLite & transport) {
+      readProperty(_cloud_value.swi);
+      readProperty(_cloud_value.vol);
+      readProperty(_cloud_value.mut);
+      readProperty((int&)_cloud_value.pbc);
+      readProperty((int&)_cloud_value.inp);
+      readProperty(_cloud_value.cha);
+    }
+    virtual void iotWriteProperty(ArduinoCloudTransportLite & transport) {
+      writeAttribute(_value.swi, _cloud_value.swi);
+      writeAttribute(_value.vol, _cloud_value.vol);
+      writeAttribute(_value.mut, _cloud_value.mut);
+      writeAttribute((int&)_value.pbc, (int&)_cloud_value.pbc);
+      writeAttribute((int&)_value.inp, (int&)_cloud_value.inp);
+      writeAttribute(_value.cha, _cloud_value.cha);
     }
 };
 
+static_assert(sizeof(CloudTelevision) <= cloudPropertySizeBudget(2 * sizeof(Television)), "CloudTelevision grew past its size budget");
+
 #endif /* CLOUDTELEVISION_H_ */
\ No newline at end of file
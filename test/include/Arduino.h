@@ -0,0 +1,55 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+#ifndef TEST_ARDUINO_H_
+#define TEST_ARDUINO_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+/* Arduino's abs() is a macro which accepts any arithmetic type */
+using std::abs;
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
+
+typedef std::string String;
+
+/******************************************************************************
+   FUNCTION DECLARATION
+ ******************************************************************************/
+
+/* The clock of the host build only moves through delay()/delayMicroseconds() and setMicros(), so that the tests are deterministic */
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void setMicros(unsigned long us);
+
+#endif /* TEST_ARDUINO_H_ */
@@ -0,0 +1,87 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+#ifndef TEST_WIFI_NINA_LITE_H_
+#define TEST_WIFI_NINA_LITE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* The property API of the NINA module, as called by ArduinoCloudTransportWiFiLite. Reads leave the values untouched,
+   writes only count the calls and remember the last name. Only the Int writes accept a timestamp */
+class WiFiLiteClass {
+  public:
+    WiFiLiteClass() : calls(0), status_calls(0), last_timestamp(0), status_code(3) {}
+
+    int           calls;
+    /* status() is an SPI command on the module too, it is counted apart from the property calls */
+    int           status_calls;
+    String        last_name;
+    unsigned long last_timestamp;
+    /* WiFiNINA status code, WL_CONNECTED by default */
+    uint8_t       status_code;
+
+    uint8_t status() {
+      status_calls++;
+      return status_code;
+    }
+
+    void iotReadPropertyBool(char const * name, bool * /* value */, unsigned long * /* timestamp */) {
+      call(name);
+    }
+    void iotReadPropertyInt(char const * name, int * /* value */, unsigned long * /* timestamp */) {
+      call(name);
+    }
+    void iotReadPropertyFloat(char const * name, float * /* value */, unsigned long * /* timestamp */) {
+      call(name);
+    }
+    void iotReadPropertyString(char const * name, String & /* value */, unsigned long * /* timestamp */) {
+      call(name);
+    }
+    void iotWritePropertyBool(char const * name, bool /* value */) {
+      call(name);
+    }
+    void iotWritePropertyInt(char const * name, int /* value */) {
+      call(name);
+    }
+    void iotWritePropertyInt(char const * name, int /* value */, unsigned long timestamp) {
+      call(name);
+      last_timestamp = timestamp;
+    }
+    void iotWritePropertyFloat(char const * name, float /* value */) {
+      call(name);
+    }
+    void iotWritePropertyString(char const * name, String /* value */) {
+      call(name);
+    }
+
+  private:
+    void call(char const * name) {
+      calls++;
+      last_name = name;
+    }
+};
+
+#endif /* TEST_WIFI_NINA_LITE_H_ */
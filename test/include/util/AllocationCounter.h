@@ -0,0 +1,29 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+#ifndef TEST_UTIL_ALLOCATION_COUNTER_H_
+#define TEST_UTIL_ALLOCATION_COUNTER_H_
+
+/******************************************************************************
+   FUNCTION DECLARATION
+ ******************************************************************************/
+
+/* Number of calls of the global operator new since the start of the program, which the test utilities replace to count them.
+   On the host String is std::string, which allocates for strings too long for its inline buffer of 15 characters */
+unsigned long allocationCount();
+
+#endif /* TEST_UTIL_ALLOCATION_COUNTER_H_ */
@@ -0,0 +1,103 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+#ifndef TEST_UTIL_TRANSPORT_SPY_H_
+#define TEST_UTIL_TRANSPORT_SPY_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <vector>
+
+#include <ArduinoCloudFrameLite.h>
+#include <ArduinoCloudPropertyLite.h>
+#include <ArduinoCloudTransportLite.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Transport recording what it is given: every single write and every entry of the write frames, in order.
+   Reads leave the values untouched. Frames are advertised only if setFramesSupported(true) */
+class TransportSpy : public ArduinoCloudTransportLite {
+  public:
+    struct Write {
+      String        name;
+      uint16_t      identifier;
+      Type          type;
+      bool          bool_value;
+      int           int_value;
+      float         float_value;
+      String        string_value;
+      /* Whether the value carries a timestamp: the timestamp flag of frame entries, or a timestamped single write */
+      bool          timestamped;
+      unsigned long timestamp;
+      /* Index of the frame holding the entry, -1 for single writes */
+      int           frame;
+    };
+
+    TransportSpy();
+
+    inline void setFramesSupported(bool const frames) {
+      _frames = frames;
+    }
+    inline void setConnected(bool const connected) {
+      _connected = connected;
+    }
+    /* The link drops once that many more writes have been received, -1 never */
+    inline void disconnectAfter(int const writes) {
+      _disconnect_after = writes;
+    }
+
+    std::vector<Write> writes;
+    int                frames;
+    int                reads;
+
+    virtual void iotReadPropertyBool(char const * name, uint16_t const identifier, bool & value, unsigned long & timestamp);
+    virtual void iotReadPropertyInt(char const * name, uint16_t const identifier, int & value, unsigned long & timestamp);
+    virtual void iotReadPropertyFloat(char const * name, uint16_t const identifier, float & value, unsigned long & timestamp);
+    virtual void iotReadPropertyString(char const * name, uint16_t const identifier, String & value, unsigned long & timestamp);
+
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value);
+    virtual void iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp);
+    virtual void iotWritePropertyInt(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp);
+    virtual void iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp);
+    virtual void iotWritePropertyString(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp);
+
+    virtual bool isConnected() {
+      return _connected;
+    }
+    virtual bool supportsFrames() {
+      return _frames;
+    }
+    virtual void iotWriteProperties(uint8_t const * frame, size_t const length);
+
+  private:
+    bool _frames;
+    bool _connected;
+    int  _disconnect_after;
+
+    Write & record(char const * name, uint16_t const identifier, Type const type);
+    Write & record(char const * name, uint16_t const identifier, Type const type, unsigned long const timestamp);
+};
+
+#endif /* TEST_UTIL_TRANSPORT_SPY_H_ */
@@ -0,0 +1,117 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include <types/CloudColor.h>
+
+/******************************************************************************
+   CONSTANTS
+ ******************************************************************************/
+
+/* HSB grid converted by each kernel: every hue in 0.5 degree steps, saturation and brightness in 2.5 % steps, ROUNDS times */
+static int const HUE_STEPS = 720;
+static int const LEVEL_STEPS = 41;
+static int const ROUNDS = 5;
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
+
+struct Result {
+  double        nanos_per_conversion;
+  unsigned long checksum;
+};
+
+/******************************************************************************
+   FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* The checksum of the levels keeps the compiler from dropping the conversions */
+template <typename KERNEL>
+static Result run(char const * name, KERNEL kernel) {
+  Result result = {0.0, 0};
+  unsigned long conversions = 0;
+  std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (int h = 0; h < HUE_STEPS; h++) {
+      for (int s = 0; s < LEVEL_STEPS; s++) {
+        for (int b = 0; b < LEVEL_STEPS; b++) {
+          Color color(h * 0.5f, s * 2.5f, b * 2.5f);
+          uint8_t R, G, B;
+          kernel(color, R, G, B);
+          result.checksum += R + (G << 8) + (B << 16);
+          conversions++;
+        }
+      }
+    }
+  }
+  std::chrono::steady_clock::duration const elapsed = std::chrono::steady_clock::now() - start;
+  result.nanos_per_conversion = std::chrono::duration<double, std::nano>(elapsed).count() / conversions;
+  printf("%-12s %lu conversions, %7.2f ns per conversion, checksum %lu\n", name, conversions, result.nanos_per_conversion, result.checksum);
+  return result;
+}
+
+static void getRGBFixed(Color & color, uint8_t & R, uint8_t & G, uint8_t & B) {
+  color.getRGB(R, G, B);
+}
+
+static void getRGBFloat(Color & color, uint8_t & R, uint8_t & G, uint8_t & B) {
+  color.getRGBFloat(R, G, B);
+}
+
+/* Largest difference of a channel between the kernels over the grid */
+static int maxDifference() {
+  int max = 0;
+  for (int h = 0; h < HUE_STEPS; h++) {
+    for (int s = 0; s < LEVEL_STEPS; s++) {
+      for (int b = 0; b < LEVEL_STEPS; b++) {
+        Color color(h * 0.5f, s * 2.5f, b * 2.5f);
+        uint8_t fixed[3], reference[3];
+        color.getRGB(fixed[0], fixed[1], fixed[2]);
+        color.getRGBFloat(reference[0], reference[1], reference[2]);
+        for (int i = 0; i < 3; i++) {
+          int const difference = abs(fixed[i] - reference[i]);
+          max = (difference > max) ? difference : max;
+        }
+      }
+    }
+  }
+  return max;
+}
+
+/******************************************************************************
+   MAIN
+ ******************************************************************************/
+
+/* Throughput of the fixed point getRGB() and of the float kernel on the host. The host has an FPU, unlike the Cortex-M0+ targets
+   the fixed point kernel is written for, so the ratio is only indicative. Fails if a level of the kernels differs by more than 1 */
+int main() {
+  Result const fixed = run("fixed point", getRGBFixed);
+  Result const reference = run("float", getRGBFloat);
+  printf("fixed point / float time ratio: %.2f\n", fixed.nanos_per_conversion / reference.nanos_per_conversion);
+  int const difference = maxDifference();
+  printf("largest level difference: %d\n", difference);
+  return (difference <= 1) ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stdio.h>
+
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+/******************************************************************************
+   CONSTANTS
+ ******************************************************************************/
+
+/* 8 properties published at unrelated intervals, one of them changed every 100 ms, for 10 minutes */
+static int const PROPERTIES = 8;
+static unsigned long const INTERVALS[PROPERTIES] = {10, 15, 60, 7, 12, 20, 30, 45};
+static unsigned long const STEP_MILLIS = 100;
+static unsigned long const DURATION_MILLIS = 600000;
+/* Cost of a radio exchange: 20 ms per call plus 10 us per byte */
+static unsigned long const CALL_MICROS = 20000;
+static unsigned long const BYTE_MICROS = 10;
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
+
+struct Result {
+  unsigned long bursts,
+                updates,
+                calls,
+                bytes,
+                radio_millis;
+};
+
+/******************************************************************************
+   FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* A burst is a writeProperties() which reached the transport, radio_millis the time the radio has been kept busy */
+static Result run(unsigned long const window, unsigned long const tolerance) {
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(true);
+  loopback.setLatency(CALL_MICROS, BYTE_MICROS);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+  thing.setPublishWindow(window);
+
+  CloudInt properties[PROPERTIES];
+  String names[PROPERTIES];
+  for (int i = 0; i < PROPERTIES; i++) {
+    names[i] = "p" + std::to_string(i);
+    thing.addPropertyReal(properties[i], names[i].c_str(), Permission::ReadWrite).publishEvery(INTERVALS[i], tolerance);
+  }
+
+  Result result = {0, 0, 0, 0, 0};
+  setMicros(333UL * 1000);
+  thing.writeProperties();
+  loopback.resetCounters();
+  for (unsigned long now = 400; now < DURATION_MILLIS; now += STEP_MILLIS) {
+    setMicros(now * 1000);
+    properties[(now / STEP_MILLIS) % PROPERTIES] = now;
+    unsigned long const calls = loopback.calls();
+    thing.writeProperties();
+    result.updates += PROPERTIES - thing.suppressedWrites();
+    if (loopback.calls() != calls) {
+      result.bursts++;
+    }
+  }
+  result.calls = loopback.calls();
+  result.bytes = loopback.bytes();
+  result.radio_millis = loopback.latencyMicros() / 1000;
+  printf("window %5lu ms, tolerance %5lu ms: %4lu bursts, %4lu updates, %4lu calls, %6lu bytes, radio busy %5lu ms\n",
+         window, tolerance, result.bursts, result.updates, result.calls, result.bytes, result.radio_millis);
+  return result;
+}
+
+/******************************************************************************
+   MAIN
+ ******************************************************************************/
+
+/* Radio active time of the updates published at a time interval, without and with publish windows, over the loopback.
+   Fails if the windows do not reduce the number of bursts and the radio time */
+int main() {
+  Result const baseline = run(0, 0);
+  Result const windows[] = {
+    run(10000, 5000),
+    run(5000, 5000),
+    run(10000, 10000)
+  };
+  for (Result const & result : windows) {
+    if (result.bursts >= baseline.bursts || result.radio_millis >= baseline.radio_millis) {
+      return 1;
+    }
+  }
+  return 0;
+}
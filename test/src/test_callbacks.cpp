@@ -0,0 +1,149 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+/******************************************************************************
+   GLOBAL VARIABLES
+ ******************************************************************************/
+
+static int updates = 0;
+
+/******************************************************************************
+   LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/* Takes longer than the callback budget used below */
+static void onSlowUpdate() {
+  updates++;
+  setMicros(micros() + 2000);
+}
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Callbacks queued by a read cycle are dispatched within the budget", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  updates = 0;
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt a, b;
+  a = 1;
+  b = 1;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite).onUpdate(onSlowUpdate);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite).onUpdate(onSlowUpdate);
+  thing.writeProperties();
+
+  REQUIRE(loopback.setCloudValue("a", a.identifier(), 5, 100));
+  REQUIRE(loopback.setCloudValue("b", b.identifier(), 6, 100));
+
+  WHEN("There is no budget") {
+    thing.readProperties();
+    THEN("They are all dispatched once the read cycle is over") {
+      REQUIRE(updates == 2);
+      REQUIRE_FALSE(thing.dispatchCallbacks());
+    }
+  }
+
+  WHEN("The budget is shorter than a callback") {
+    thing.setCallbackBudget(1);
+    thing.readProperties();
+    THEN("One property is dispatched per call, the values being applied already") {
+      REQUIRE(updates == 1);
+      REQUIRE(a == 5);
+      REQUIRE(b == 6);
+      while (thing.dispatchCallbacks());
+      REQUIRE(updates == 2);
+    }
+  }
+}
+
+SCENARIO("A property is queued at most once per kind of callback", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  updates = 0;
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt value;
+  value = 1;
+  thing.addPropertyReal(value, "value", Permission::ReadWrite).onUpdate(onSlowUpdate);
+  thing.writeProperties();
+
+  REQUIRE(loopback.setCloudValue("value", value.identifier(), 5, 100));
+  thing.setCallbackBudget(1);
+  thing.readProperties();
+  REQUIRE(updates == 1);
+
+  /* Changed again locally and overridden by the cloud value before the callback ran */
+  value = 7;
+  thing.updateProperty("value", 100);
+  value = 8;
+  thing.updateProperty("value", 100);
+  REQUIRE(value == 5);
+  while (thing.dispatchCallbacks());
+  REQUIRE(updates == 2);
+}
+
+SCENARIO("Callbacks left queued by poll() are dispatched before the next cycle", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  updates = 0;
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt a, b;
+  a = 1;
+  b = 1;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite).onUpdate(onSlowUpdate).onSync(CLOUD_WINS);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite).onSync(CLOUD_WINS);
+  thing.writeProperties();
+
+  REQUIRE(loopback.setCloudValue("a", a.identifier(), 5, 100));
+  REQUIRE(loopback.setCloudValue("b", b.identifier(), 5, 100));
+  thing.setCallbackBudget(1);
+  thing.beginReadProperties(true);
+  while (thing.isSyncInProgress() || updates == 0) {
+    REQUIRE(thing.poll());
+  }
+  /* The onSync callback of b is still queued */
+  REQUIRE(a == 5);
+  REQUIRE(b == 1);
+
+  WHEN("A write cycle is requested") {
+    thing.beginWriteProperties();
+    REQUIRE(thing.poll());
+    THEN("The sync callback applies the cloud value before the write cycle starts") {
+      REQUIRE(b == 5);
+      REQUIRE_FALSE(thing.isSyncInProgress());
+      while (thing.poll());
+      int cloud = 0;
+      REQUIRE(loopback.getCloudValue("b", 0, cloud));
+      REQUIRE(cloud == 5);
+    }
+  }
+}
@@ -0,0 +1,233 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include <ArduinoCloudStaticThingLite.h>
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Loopback whose link drops right after answering a change query */
+class DroppingLoopback : public ArduinoCloudTransportLoopback {
+  public:
+    DroppingLoopback() : drop_after_change_query(false) {}
+
+    bool drop_after_change_query;
+
+    virtual bool iotReadChanges(uint32_t & generation, uint8_t * changed, size_t const size) {
+      bool const known = ArduinoCloudTransportLoopback::iotReadChanges(generation, changed, size);
+      if (drop_after_change_query) {
+        setConnected(false);
+      }
+      return known;
+    }
+};
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The loopback reports the changes from the cloud side since a generation", "[ArduinoCloudTransportLoopback]") {
+  ArduinoCloudTransportLoopback loopback;
+  uint8_t changed[ArduinoCloudTransportLite::CHANGE_BITMAP_SIZE] = {0};
+  uint32_t generation = 0;
+
+  REQUIRE(loopback.iotReadChanges(generation, changed, sizeof(changed)));
+  REQUIRE(generation == 0);
+
+  loopback.setCloudValue("a", 3, 1, 10);
+  loopback.setCloudValue("b", 12, 2, 10);
+  /* Writes from the device are not changes from the cloud side */
+  loopback.iotWritePropertyInt("c", 20, 3);
+
+  REQUIRE(loopback.iotReadChanges(generation, changed, sizeof(changed)));
+  REQUIRE(generation == 2);
+  REQUIRE(changed[0] == (1 << 3));
+  REQUIRE(changed[1] == (1 << 4));
+  REQUIRE(changed[2] == 0);
+
+  memset(changed, 0, sizeof(changed));
+  REQUIRE(loopback.iotReadChanges(generation, changed, sizeof(changed)));
+  REQUIRE(generation == 2);
+  REQUIRE(changed[0] == 0);
+  REQUIRE(changed[1] == 0);
+
+  WHEN("The bitmap is too small for a changed identifier") {
+    loopback.setCloudValue("b", 12, 5, 20);
+    THEN("The changes can not be told apart") {
+      REQUIRE_FALSE(loopback.iotReadChanges(generation, changed, 1));
+    }
+  }
+}
+
+SCENARIO("A read cycle fetches only the properties changed from the cloud side", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  std::vector<String> names;
+  for (int i = 0; i < 20; i++) {
+    names.push_back("property" + std::to_string(i));
+  }
+  CloudInt properties[20];
+  for (int i = 0; i < 20; i++) {
+    properties[i] = i;
+    thing.addPropertyReal(properties[i], names[i].c_str(), Permission::ReadWrite);
+  }
+  thing.writeProperties();
+
+  WHEN("Nothing has changed") {
+    loopback.resetCounters();
+    thing.readProperties();
+    THEN("The change query is the only exchange") {
+      REQUIRE(loopback.calls() == 1);
+    }
+  }
+  WHEN("A property has changed") {
+    thing.readProperties();
+    REQUIRE(loopback.setCloudValue("property7", 8, 700, 1000));
+    loopback.resetCounters();
+    thing.readProperties();
+    THEN("Only that property is read and updated") {
+      REQUIRE(loopback.calls() == 2);
+      REQUIRE(properties[7] == 700);
+      REQUIRE(properties[6] == 6);
+    }
+  }
+  WHEN("A sync read is requested") {
+    thing.readProperties();
+    loopback.resetCounters();
+    thing.readProperties(true);
+    THEN("Every property is read") {
+      REQUIRE(loopback.calls() == 20);
+    }
+  }
+  WHEN("The transport does not support change queries") {
+    loopback.setChangeQueriesSupported(false);
+    loopback.resetCounters();
+    thing.readProperties();
+    THEN("Every property is read") {
+      REQUIRE(loopback.calls() == 20);
+    }
+  }
+}
+
+SCENARIO("Changed properties are read through a single query frame", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt a, b, c;
+  a = 1;
+  b = 2;
+  c = 3;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.addPropertyReal(c, "c", Permission::ReadWrite);
+  thing.writeProperties();
+  thing.readProperties();
+
+  REQUIRE(loopback.setCloudValue("a", 1, 10, 1000));
+  REQUIRE(loopback.setCloudValue("c", 3, 30, 1000));
+  loopback.resetCounters();
+  thing.readProperties();
+
+  REQUIRE(loopback.calls() == 2);
+  REQUIRE(a == 10);
+  REQUIRE(b == 2);
+  REQUIRE(c == 30);
+}
+
+SCENARIO("The changes of a read cycle cut short by the link are reported again", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt a, b;
+  a = 1;
+  b = 2;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.writeProperties();
+  thing.readProperties();
+
+  REQUIRE(loopback.setCloudValue("a", 1, 10, 1000));
+  REQUIRE(loopback.setCloudValue("b", 2, 20, 1000));
+
+  /* Change query, then the read of a, then the link drops before b is read */
+  thing.beginReadProperties();
+  REQUIRE(thing.poll());
+  REQUIRE(thing.poll());
+  REQUIRE(a == 10);
+  loopback.setConnected(false);
+  while (thing.poll());
+  REQUIRE(b == 2);
+
+  WHEN("The link is back") {
+    loopback.setConnected(true);
+    thing.readProperties();
+    THEN("The next read cycle reads the change it missed") {
+      REQUIRE(b == 20);
+    }
+    THEN("Once read, the changes are not reported again") {
+      loopback.resetCounters();
+      thing.readProperties();
+      REQUIRE(loopback.calls() == 1);
+    }
+  }
+}
+
+SCENARIO("A static Thing commits the generation only after a complete read cycle", "[ArduinoCloudStaticThingLite]") {
+  setMicros(0);
+  DroppingLoopback loopback;
+  CloudInt a, b;
+  a = 1;
+  b = 2;
+  ArduinoCloudStaticThingLite<CloudInt, CloudInt> thing(loopback, a, b);
+  thing.begin();
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.writeProperties();
+  thing.readProperties();
+
+  REQUIRE(loopback.setCloudValue("b", 2, 20, 1000));
+  /* The change query goes through, the query frame is lost */
+  loopback.drop_after_change_query = true;
+  thing.readProperties();
+  REQUIRE(b == 2);
+
+  loopback.drop_after_change_query = false;
+  loopback.setConnected(true);
+  thing.readProperties();
+  REQUIRE(b == 20);
+}
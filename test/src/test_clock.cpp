@@ -0,0 +1,199 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudClockLite.h>
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+/******************************************************************************
+   GLOBAL VARIABLES
+ ******************************************************************************/
+
+/* Start of the wrapping clock below: it wraps around 1 s after millis() is 0, as millis() does on a target after ~49.7 days */
+static unsigned long const WRAP_OFFSET = static_cast<unsigned long>(0) - 1000;
+
+/******************************************************************************
+   LOCAL FUNCTIONS
+ ******************************************************************************/
+
+static unsigned long frozenClock() {
+  return 12345;
+}
+
+static unsigned long wrappingClock() {
+  return WRAP_OFFSET + millis();
+}
+
+/* The cloud clock is global, it is restored to millis() whatever the outcome of the scenario */
+struct CloudClockGuard {
+  CloudClockGuard(CloudClockFunc const clock) {
+    setCloudClock(clock);
+  }
+  ~CloudClockGuard() {
+    setCloudClock(NULL);
+  }
+};
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The cloud clock is millis() unless replaced", "[ArduinoCloudClockLite]") {
+  setMicros(5000UL * 1000);
+  REQUIRE(cloudMillis() == 5000);
+  {
+    CloudClockGuard guard(frozenClock);
+    REQUIRE(cloudMillis() == 12345);
+    setMicros(6000UL * 1000);
+    REQUIRE(cloudMillis() == 12345);
+  }
+  REQUIRE(cloudMillis() == 6000);
+}
+
+SCENARIO("A read is due once the read period has elapsed since the last read cycle", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt value;
+  value = 0;
+  thing.addPropertyReal(value, "value", Permission::ReadWrite);
+  thing.writeProperties();
+
+  WHEN("There is no read period") {
+    THEN("A read is never due") {
+      REQUIRE_FALSE(thing.isReadDue());
+      setMicros(3600UL * 1000 * 1000);
+      REQUIRE_FALSE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == NO_DEADLINE);
+    }
+  }
+  WHEN("There is a read period") {
+    thing.setReadPeriod(1000);
+    THEN("The first read is due right away") {
+      REQUIRE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == 0);
+    }
+    THEN("The next one once the period has elapsed") {
+      setMicros(500UL * 1000);
+      thing.readProperties();
+      REQUIRE_FALSE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == 1000);
+      setMicros(1499UL * 1000);
+      REQUIRE_FALSE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == 1);
+      setMicros(1500UL * 1000);
+      REQUIRE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == 0);
+    }
+  }
+  WHEN("The cloud clock wraps around between two reads") {
+    CloudClockGuard guard(wrappingClock);
+    thing.setReadPeriod(1000);
+    setMicros(500UL * 1000);
+    thing.readProperties();
+    REQUIRE(cloudMillis() == WRAP_OFFSET + 500);
+    THEN("The period is measured across the wrap around") {
+      setMicros(1200UL * 1000);
+      REQUIRE(cloudMillis() == 200);
+      REQUIRE_FALSE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == 300);
+      setMicros(1500UL * 1000);
+      REQUIRE(thing.isReadDue());
+      REQUIRE(thing.nextActionMillis() == 0);
+    }
+  }
+}
+
+SCENARIO("The next action is the earliest of the next deadline and the next read", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt periodic, on_change;
+  periodic = 1;
+  on_change = 2;
+  thing.addPropertyReal(periodic, "periodic", Permission::Read).publishEvery(10 * SECONDS);
+  thing.addPropertyReal(on_change, "on_change", Permission::Read);
+  thing.writeProperties();
+  REQUIRE(thing.nextDeadlineMillis() == 10000);
+  REQUIRE(thing.nextActionMillis() == 10000);
+
+  WHEN("A read period shorter than the interval is set") {
+    thing.setReadPeriod(3000);
+    thing.readProperties();
+    setMicros(1000UL * 1000);
+    THEN("The next read comes first") {
+      REQUIRE(thing.nextActionMillis() == 2000);
+    }
+  }
+  WHEN("A read period longer than the interval is set") {
+    thing.setReadPeriod(30000);
+    thing.readProperties();
+    setMicros(1000UL * 1000);
+    THEN("The next deadline comes first") {
+      REQUIRE(thing.nextActionMillis() == 9000);
+    }
+  }
+  WHEN("A property is changed") {
+    on_change = 3;
+    THEN("There is work to do right away") {
+      REQUIRE(thing.nextActionMillis() == 0);
+    }
+  }
+  WHEN("A cycle is requested") {
+    thing.beginWriteProperties();
+    THEN("There is work to do until it is over") {
+      REQUIRE(thing.nextActionMillis() == 0);
+      while (thing.poll());
+      REQUIRE(thing.nextActionMillis() == 10000);
+    }
+  }
+}
+
+SCENARIO("The next deadline is measured across the wrap around of the cloud clock", "[ArduinoCloudThingLite]") {
+  CloudClockGuard guard(wrappingClock);
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt periodic;
+  periodic = 1;
+  thing.addPropertyReal(periodic, "periodic", Permission::Read).publishEvery(2 * SECONDS);
+  thing.writeProperties();
+  REQUIRE(thing.nextActionMillis() == 2000);
+
+  setMicros(1500UL * 1000);
+  REQUIRE(cloudMillis() == 500);
+  REQUIRE(thing.nextActionMillis() == 500);
+
+  loopback.resetCounters();
+  setMicros(2000UL * 1000);
+  REQUIRE(thing.nextActionMillis() == 0);
+  thing.writeProperties();
+  REQUIRE(loopback.calls() == 1);
+  REQUIRE(thing.nextActionMillis() == 2000);
+}
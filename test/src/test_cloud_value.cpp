@@ -0,0 +1,160 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudStaticThingLite.h>
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("A cloud value read while a local change is held back does not revert it", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt value;
+  value = 1;
+  thing.addPropertyReal(value, "value", Permission::ReadWrite).publishOnChange(0, 5000);
+  REQUIRE(loopback.setCloudValue("value", value.identifier(), 1, 100));
+  thing.writeProperties();
+  thing.readProperties();
+
+  value = 2;
+  setMicros(1000UL * 1000);
+  thing.writeProperties();
+  int cloud = 0;
+  REQUIRE(loopback.getCloudValue("value", 0, cloud));
+  REQUIRE(cloud == 1);
+
+  WHEN("The transport does not report when the cloud value changed") {
+    REQUIRE(loopback.setCloudValue("value", value.identifier(), 1, 0));
+    thing.readProperties();
+    THEN("The local change is kept and published once the minimum time has elapsed") {
+      REQUIRE(value == 2);
+      setMicros(5000UL * 1000);
+      thing.writeProperties();
+      REQUIRE(loopback.getCloudValue("value", 0, cloud));
+      REQUIRE(cloud == 2);
+    }
+  }
+  WHEN("The cloud value is read again unchanged from the cloud side") {
+    /* Same timestamp, the value matching the local change */
+    REQUIRE(loopback.setCloudValue("value", value.identifier(), 2, 100));
+    thing.readProperties();
+    THEN("The value the local change is published against is left untouched") {
+      setMicros(5000UL * 1000);
+      loopback.resetCounters();
+      thing.writeProperties();
+      REQUIRE(loopback.calls() == 1);
+    }
+  }
+  WHEN("The cloud value has been changed from the cloud side") {
+    REQUIRE(loopback.setCloudValue("value", value.identifier(), 3, 200));
+    thing.readProperties();
+    THEN("It is applied") {
+      REQUIRE(value == 3);
+      REQUIRE(value.getLastCloudChangeTimestamp() == 200);
+    }
+  }
+}
+
+SCENARIO("A cloud value without timestamp is applied when there is no local change", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt value;
+  value = 1;
+  thing.addPropertyReal(value, "value", Permission::ReadWrite);
+  thing.writeProperties();
+
+  REQUIRE(loopback.setCloudValue("value", value.identifier(), 4, 0));
+  thing.readProperties();
+  REQUIRE(value == 4);
+}
+
+SCENARIO("A cloud value too long to be saved is read once from the transport", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  loopback.setChangeQueriesSupported(false);
+
+  CloudString text;
+  thing.addPropertyReal(text, "text", Permission::ReadWrite);
+  thing.writeProperties();
+
+  String const long_text(250, 'x');
+  REQUIRE(loopback.setCloudValue("text", text.identifier(), long_text, 100));
+  loopback.resetCounters();
+  thing.readProperties();
+  REQUIRE(text == long_text);
+  REQUIRE(loopback.calls() == 1);
+
+  WHEN("A local change is pending while the cloud value is unchanged") {
+    text = "short";
+    loopback.resetCounters();
+    thing.readProperties();
+    THEN("The local change is kept and published although the previous cloud value could not be saved") {
+      REQUIRE(text == "short");
+      REQUIRE(loopback.calls() == 1);
+      thing.writeProperties();
+      String cloud;
+      REQUIRE(loopback.getCloudValue("text", 0, cloud));
+      REQUIRE(cloud == "short");
+    }
+  }
+}
+
+SCENARIO("A static Thing does not revert a held back local change either", "[ArduinoCloudStaticThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  CloudInt value;
+  value = 1;
+  ArduinoCloudStaticThingLite<CloudInt> thing(loopback, value);
+  thing.begin();
+  thing.addPropertyReal(value, "value", Permission::ReadWrite).publishOnChange(0, 5000);
+  thing.writeProperties();
+
+  value = 2;
+  setMicros(1000UL * 1000);
+  thing.writeProperties();
+  REQUIRE(loopback.setCloudValue("value", value.identifier(), 1, 0));
+  thing.readProperties();
+  REQUIRE(value == 2);
+
+  setMicros(5000UL * 1000);
+  thing.writeProperties();
+  int cloud = 0;
+  REQUIRE(loopback.getCloudValue("value", 0, cloud));
+  REQUIRE(cloud == 2);
+}
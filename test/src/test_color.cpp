@@ -0,0 +1,165 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <algorithm>
+
+#include <types/CloudColor.h>
+
+/******************************************************************************
+   FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Distance between two hues, across 0/360 */
+static double hueDistance(double const a, double const b) {
+  double const d = fabs(a - b);
+  return (d > 180) ? (360 - d) : d;
+}
+
+/* Exact channel levels of an HSB color, in [0, 255] */
+static void exactRGB(double const hue, double const sat, double const bri, double level[3]) {
+  double const c = (bri / 100) * (sat / 100);
+  double const h = hue / 60;
+  double const x = c * (1 - fabs(fmod(h, 2) - 1));
+  double const m = (bri / 100) - c;
+  int const sector = static_cast<int>(h) % 6;
+  double const components[6][3] = {
+    {c, x, 0}, {x, c, 0}, {0, c, x}, {0, x, c}, {x, 0, c}, {c, 0, x}
+  };
+  for (int i = 0; i < 3; i++) {
+    level[i] = (components[sector][i] + m) * 255;
+  }
+}
+
+/* Whether the rounding of level may go either way */
+static bool isNearRoundingBoundary(double const level) {
+  double const fraction = level - floor(level);
+  return fabs(fraction - 0.5) <= 0.01;
+}
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The fixed point conversions of every RGB color stay within their bounds of the float kernels", "[CloudColor]") {
+  double max_hue_error = 0,
+         max_sat_error = 0,
+         max_bri_error = 0,
+         min_hue = 360,
+         max_hue = 0;
+  unsigned long round_trip_errors = 0;
+
+  for (int r = 0; r < 256; r++) {
+    for (int g = 0; g < 256; g++) {
+      for (int b = 0; b < 256; b++) {
+        Color fixed(0, 0, 0), reference(0, 0, 0);
+        fixed.setColorRGB(r, g, b);
+        reference.setColorRGBFloat(r, g, b);
+        max_hue_error = std::max(max_hue_error, hueDistance(fixed.hue, reference.hue));
+        max_sat_error = std::max(max_sat_error, fabs(static_cast<double>(fixed.sat) - reference.sat));
+        max_bri_error = std::max(max_bri_error, fabs(static_cast<double>(fixed.bri) - reference.bri));
+        min_hue = std::min(min_hue, std::min<double>(fixed.hue, reference.hue));
+        max_hue = std::max(max_hue, std::max<double>(fixed.hue, reference.hue));
+
+        uint8_t R, G, B;
+        fixed.getRGB(R, G, B);
+        if (R != r || G != g || B != b) {
+          round_trip_errors++;
+        }
+      }
+    }
+  }
+
+  REQUIRE(max_hue_error <= 0.0002);
+  REQUIRE(max_sat_error <= 0.00002);
+  REQUIRE(max_bri_error <= 0.00002);
+  REQUIRE(round_trip_errors == 0);
+  /* The hue of red leaning to blue is brought back from the negative side by both kernels */
+  REQUIRE(min_hue >= 0);
+  REQUIRE(max_hue < 360);
+}
+
+SCENARIO("The fixed point RGB of an HSB color is within 1 of the float kernel, only near a rounding boundary", "[CloudColor]") {
+  unsigned long out_of_bounds = 0;
+
+  for (int hue = 0; hue < 3600; hue += 7) {
+    for (int sat = 0; sat <= 1000; sat += 13) {
+      for (int bri = 0; bri <= 1000; bri += 17) {
+        Color color(hue / 10.0f, sat / 10.0f, bri / 10.0f);
+        uint8_t fixed[3], reference[3];
+        color.getRGB(fixed[0], fixed[1], fixed[2]);
+        color.getRGBFloat(reference[0], reference[1], reference[2]);
+        double exact[3];
+        exactRGB(color.hue, color.sat, color.bri, exact);
+        for (int i = 0; i < 3; i++) {
+          int const error = abs(fixed[i] - reference[i]);
+          if (error > 1 || (error == 1 && !isNearRoundingBoundary(exact[i]))) {
+            out_of_bounds++;
+          }
+        }
+      }
+    }
+  }
+
+  /* Many levels of the grid fall right on a boundary, e.g. 127.5 for a brightness of 50, which lrint() rounds to even */
+  REQUIRE(out_of_bounds == 0);
+}
+
+SCENARIO("Hues are in [0, 360)", "[CloudColor]") {
+  Color fixed(0, 0, 0), reference(0, 0, 0);
+
+  WHEN("Red leans to blue") {
+    fixed.setColorRGB(255, 0, 1);
+    reference.setColorRGBFloat(255, 0, 1);
+    THEN("The hue is just below 360 instead of negative") {
+      REQUIRE(reference.hue == Approx(360.0 - 60.0 / 255));
+      REQUIRE(fixed.hue == Approx(reference.hue).margin(0.0002));
+      REQUIRE(reference.hue < 360);
+    }
+  }
+  WHEN("Red leans to green") {
+    fixed.setColorRGB(255, 1, 0);
+    reference.setColorRGBFloat(255, 1, 0);
+    THEN("The hue is just above 0") {
+      REQUIRE(reference.hue == Approx(60.0 / 255));
+      REQUIRE(fixed.hue == Approx(reference.hue).margin(0.0002));
+    }
+  }
+  WHEN("The color is grey") {
+    fixed.setColorRGB(128, 128, 128);
+    reference.setColorRGBFloat(128, 128, 128);
+    THEN("The hue is 0") {
+      REQUIRE(fixed.hue == 0);
+      REQUIRE(reference.hue == 0);
+    }
+  }
+  WHEN("A hue of 360 is converted back to RGB") {
+    Color color(360, 100, 100);
+    uint8_t R, G, B;
+    color.getRGB(R, G, B);
+    THEN("It is the same as 0, pure red") {
+      REQUIRE(R == 255);
+      REQUIRE(G == 0);
+      REQUIRE(B == 0);
+    }
+  }
+}
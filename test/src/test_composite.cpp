@@ -0,0 +1,254 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+#include <util/TransportSpy.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("A composite property sends only the attributes which differ from the cloud", "[Composite]") {
+  setMicros(0);
+  TransportSpy spy;
+  ArduinoCloudThingLite thing(spy);
+  thing.begin();
+
+  CloudTelevision tv(false, 10, false, PlaybackCommands::None, InputValue::TV, 1);
+  CloudLocation location(45.0f, 7.0f);
+  CloudColoredLight light(false, 0.0f, 0.0f, 0.0f);
+  thing.addPropertyReal(tv, "tv", Permission::ReadWrite, 1);
+  thing.addPropertyReal(location, "location", Permission::ReadWrite, 2);
+  thing.addPropertyReal(light, "light", Permission::ReadWrite, 3);
+
+  thing.writeProperties();
+
+  THEN("The first update carries every attribute, each with its own identifier") {
+    REQUIRE(spy.writes.size() == 12);
+    REQUIRE(spy.writes[0].name == "tv:swi");
+    REQUIRE(spy.writes[5].name == "tv:cha");
+    REQUIRE(spy.writes[5].identifier == ((6 << 8) | 1));
+    REQUIRE(spy.writes[6].name == "location:lat");
+    REQUIRE(spy.writes[7].name == "location:lon");
+    REQUIRE(spy.writes[8].name == "light:swi");
+    REQUIRE(spy.writes[11].name == "light:bri");
+  }
+
+  WHEN("A single attribute of each property changes") {
+    spy.writes.clear();
+    tv = Television(false, 20, false, PlaybackCommands::None, InputValue::TV, 1);
+    location = Location(45.0f, 8.0f);
+    light.setSaturation(50.0f);
+    thing.writeProperties();
+    THEN("Only that attribute is sent, with the identifier it has in a full update") {
+      REQUIRE(spy.writes.size() == 3);
+      REQUIRE(spy.writes[0].name == "tv:vol");
+      REQUIRE(spy.writes[0].identifier == ((2 << 8) | 1));
+      REQUIRE(spy.writes[0].int_value == 20);
+      REQUIRE(spy.writes[1].name == "location:lon");
+      REQUIRE(spy.writes[1].identifier == ((2 << 8) | 2));
+      REQUIRE(spy.writes[1].float_value == 8.0f);
+      REQUIRE(spy.writes[2].name == "light:sat");
+      REQUIRE(spy.writes[2].identifier == ((3 << 8) | 3));
+      REQUIRE(spy.writes[2].float_value == 50.0f);
+    }
+  }
+
+  WHEN("Attributes on both sides of unchanged ones change") {
+    spy.writes.clear();
+    tv = Television(true, 10, false, PlaybackCommands::None, InputValue::TV, 7);
+    thing.writeProperties();
+    THEN("The unchanged attributes in between are skipped without shifting the identifiers") {
+      REQUIRE(spy.writes.size() == 2);
+      REQUIRE(spy.writes[0].name == "tv:swi");
+      REQUIRE(spy.writes[0].identifier == ((1 << 8) | 1));
+      REQUIRE(spy.writes[1].name == "tv:cha");
+      REQUIRE(spy.writes[1].identifier == ((6 << 8) | 1));
+      REQUIRE(spy.writes[1].int_value == 7);
+    }
+  }
+}
+
+SCENARIO("A periodic update of a composite property carries every attribute", "[Composite]") {
+  setMicros(0);
+  TransportSpy spy;
+  ArduinoCloudThingLite thing(spy);
+  thing.begin();
+
+  CloudTelevision tv(false, 10, false, PlaybackCommands::None, InputValue::TV, 1);
+  thing.addPropertyReal(tv, "tv", Permission::ReadWrite).publishEvery(1);
+  thing.writeProperties();
+
+  spy.writes.clear();
+  tv = Television(false, 20, false, PlaybackCommands::None, InputValue::TV, 1);
+  setMicros(1000000);
+  thing.writeProperties();
+
+  REQUIRE(spy.writes.size() == 6);
+  REQUIRE(spy.writes[1].name == "tv:vol");
+  REQUIRE(spy.writes[1].int_value == 20);
+}
+
+SCENARIO("A partial update from the cloud does not revert the pending local changes of the other attributes", "[Composite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  loopback.setChangeQueriesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudTelevision tv(false, 10, false, PlaybackCommands::None, InputValue::TV, 1);
+  CloudDimmedLight light(false, 0.0f);
+  CloudLocation location(45.0f, 7.0f);
+  thing.addPropertyReal(tv, "tv", Permission::ReadWrite);
+  thing.addPropertyReal(light, "light", Permission::ReadWrite);
+  thing.addPropertyReal(location, "location", Permission::ReadWrite);
+  thing.writeProperties();
+
+  WHEN("The cloud changes the channel while a local volume change is pending") {
+    tv = Television(false, 20, false, PlaybackCommands::None, InputValue::TV, 1);
+    REQUIRE(loopback.setCloudValue("tv:cha", 0, 42, 100));
+    thing.readProperties();
+    THEN("Only the channel is taken from the cloud") {
+      REQUIRE(tv.isAttributeChangedByCloud(5));
+      for (uint8_t index = 0; index < 5; index++) {
+        REQUIRE_FALSE(tv.isAttributeChangedByCloud(index));
+      }
+      REQUIRE(tv.getChannel() == 42);
+      REQUIRE(tv.getVolume() == 20);
+    }
+    THEN("The volume is still sent, on its own") {
+      loopback.resetCounters();
+      thing.writeProperties();
+      int volume = 0;
+      REQUIRE(loopback.getCloudValue("tv:vol", 0, volume));
+      REQUIRE(volume == 20);
+      REQUIRE(loopback.calls() == 1);
+    }
+  }
+
+  WHEN("The cloud changes the brightness while a local switch change is pending") {
+    light.setSwitch(true);
+    REQUIRE(loopback.setCloudValue("light:bri", 0, 80.0f, 100));
+    thing.readProperties();
+    THEN("Only the brightness is taken from the cloud") {
+      REQUIRE_FALSE(light.isAttributeChangedByCloud(0));
+      REQUIRE(light.isAttributeChangedByCloud(1));
+      REQUIRE(light.getSwitch());
+      REQUIRE(light.getBrightness() == 80.0f);
+    }
+  }
+
+  WHEN("The cloud changes the latitude while a local longitude change is pending") {
+    location = Location(45.0f, 8.0f);
+    REQUIRE(loopback.setCloudValue("location:lat", 0, 46.0f, 100));
+    thing.readProperties();
+    THEN("Only the latitude is taken from the cloud") {
+      REQUIRE(location.isAttributeChangedByCloud(0));
+      REQUIRE_FALSE(location.isAttributeChangedByCloud(1));
+      REQUIRE(location.getValue().lat == 46.0f);
+      REQUIRE(location.getValue().lon == 8.0f);
+    }
+  }
+
+  WHEN("The cloud changes nothing") {
+    tv = Television(false, 20, false, PlaybackCommands::None, InputValue::TV, 1);
+    thing.readProperties();
+    THEN("No attribute is reported as changed and the local change is kept") {
+      for (uint8_t index = 0; index < 6; index++) {
+        REQUIRE_FALSE(tv.isAttributeChangedByCloud(index));
+      }
+      REQUIRE(tv.getVolume() == 20);
+    }
+  }
+}
+
+SCENARIO("A CloudColoredLight takes only the changed attributes from the cloud", "[Composite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  loopback.setChangeQueriesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudColoredLight light(false, 10.0f, 20.0f, 30.0f);
+  thing.addPropertyReal(light, "light", Permission::ReadWrite);
+  thing.writeProperties();
+
+  light.setHue(100.0f);
+  REQUIRE(loopback.setCloudValue("light:swi", 0, true, 100));
+  REQUIRE(loopback.setCloudValue("light:bri", 0, 90.0f, 100));
+  thing.readProperties();
+
+  REQUIRE(light.isAttributeChangedByCloud(0));
+  REQUIRE_FALSE(light.isAttributeChangedByCloud(1));
+  REQUIRE_FALSE(light.isAttributeChangedByCloud(2));
+  REQUIRE(light.isAttributeChangedByCloud(3));
+  REQUIRE(light.getSwitch());
+  REQUIRE(light.getHue() == 100.0f);
+  REQUIRE(light.getSaturation() == 20.0f);
+  REQUIRE(light.getBrightness() == 90.0f);
+}
+
+SCENARIO("A CloudDimmedLight writes swi, bri, then the hue and sat of the color widget", "[Composite]") {
+  setMicros(0);
+
+  WHEN("It is published") {
+    TransportSpy spy;
+    ArduinoCloudThingLite thing(spy);
+    thing.begin();
+    CloudDimmedLight light(true, 40.0f);
+    thing.addPropertyReal(light, "light", Permission::ReadWrite, 5);
+    thing.writeProperties();
+    THEN("The attributes leave in that order, numbered from 1") {
+      REQUIRE(spy.writes.size() == 4);
+      char const * const names[] = { "light:swi", "light:bri", "light:hue", "light:sat" };
+      for (int i = 0; i < 4; i++) {
+        REQUIRE(spy.writes[i].name == names[i]);
+        REQUIRE(spy.writes[i].identifier == (((i + 1) << 8) | 5));
+      }
+      REQUIRE(spy.writes[0].bool_value);
+      REQUIRE(spy.writes[1].float_value == 40.0f);
+    }
+  }
+
+  WHEN("It is read back with the light payload") {
+    ArduinoCloudTransportLoopback loopback;
+    loopback.setChangeQueriesSupported(false);
+    ArduinoCloudThingLite thing(loopback);
+    thing.begin();
+    thing.setLightPayload(true);
+    CloudDimmedLight light(false, 0.0f);
+    thing.addPropertyReal(light, "light", Permission::ReadWrite, 5);
+    thing.writeProperties();
+    REQUIRE(loopback.setCloudValue(NULL, (1 << 8) | 5, true, 100));
+    REQUIRE(loopback.setCloudValue(NULL, (2 << 8) | 5, 60.0f, 100));
+    thing.readProperties();
+    THEN("swi and bri have the identifiers they are written with") {
+      REQUIRE(light.getSwitch());
+      REQUIRE(light.getBrightness() == 60.0f);
+    }
+  }
+}
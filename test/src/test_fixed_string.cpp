@@ -0,0 +1,159 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+#include <util/AllocationCounter.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("A CloudFixedString is assigned from C strings and Strings", "[CloudFixedString]") {
+  CloudFixedString<16> text;
+  REQUIRE(text.length() == 0);
+  REQUIRE(text == "");
+  REQUIRE(text.capacity() == 16);
+
+  text = "hello";
+  REQUIRE(text == "hello");
+  REQUIRE(text.length() == 5);
+  REQUIRE(String(text.c_str()) == "hello");
+
+  text = String("world!");
+  REQUIRE(text == "world!");
+  REQUIRE(text != "world");
+  REQUIRE(text.length() == 6);
+
+  CloudFixedString<16> initialized("initial");
+  REQUIRE(initialized == "initial");
+  REQUIRE_FALSE(initialized.isDifferentFromCloud());
+}
+
+SCENARIO("A CloudFixedString truncates values longer than its capacity", "[CloudFixedString]") {
+  CloudFixedString<4> text;
+
+  WHEN("A longer value is assigned") {
+    text = "abcdefgh";
+    THEN("Only the first characters are kept, '\\0' terminated") {
+      REQUIRE(text == "abcd");
+      REQUIRE(text.length() == 4);
+      REQUIRE(text.c_str()[4] == '\0');
+    }
+  }
+  WHEN("A value exactly as long as the capacity is assigned") {
+    text = String("wxyz");
+    THEN("It is kept whole") {
+      REQUIRE(text == "wxyz");
+    }
+  }
+  WHEN("A longer value is read from the cloud") {
+    ArduinoCloudTransportLoopback loopback;
+    ArduinoCloudThingLite thing(loopback);
+    thing.begin();
+    thing.addPropertyReal(text, "text", Permission::ReadWrite);
+    thing.writeProperties();
+    REQUIRE(loopback.setCloudValue("text", text.identifier(), String("0123456789"), 100));
+    thing.readProperties();
+    THEN("It is truncated as well") {
+      REQUIRE(text == "0123");
+    }
+  }
+}
+
+SCENARIO("A CloudFixedString is published only when its value changes", "[CloudFixedString]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudFixedString<16> text;
+  text = "first";
+  thing.addPropertyReal(text, "text", Permission::ReadWrite);
+  thing.writeProperties();
+  REQUIRE_FALSE(text.isDifferentFromCloud());
+
+  WHEN("The same value is assigned again") {
+    text = "first";
+    loopback.resetCounters();
+    thing.writeProperties();
+    THEN("Nothing is sent") {
+      REQUIRE_FALSE(text.isDifferentFromCloud());
+      REQUIRE(loopback.calls() == 0);
+    }
+  }
+  WHEN("A value differing only by its length is assigned") {
+    text = "firs";
+    REQUIRE(text.isDifferentFromCloud());
+    loopback.resetCounters();
+    thing.writeProperties();
+    THEN("It is sent") {
+      REQUIRE(loopback.calls() == 1);
+      String cloud;
+      REQUIRE(loopback.getCloudValue("text", 0, cloud));
+      REQUIRE(cloud == "firs");
+      REQUIRE_FALSE(text.isDifferentFromCloud());
+    }
+  }
+}
+
+SCENARIO("A CloudFixedString is read without allocating", "[CloudFixedString]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  /* Longer than the inline buffer of std::string, which String is on the host */
+  String const cloud_text(24, 'c');
+  CloudFixedString<32> text;
+  text = "local";
+  thing.addPropertyReal(text, "text", Permission::ReadWrite);
+  thing.writeProperties();
+
+  REQUIRE(loopback.setCloudValue("text", text.identifier(), cloud_text, 100));
+
+  WHEN("The cloud value is applied") {
+    unsigned long const allocations = allocationCount();
+    thing.readProperties();
+    unsigned long const allocated = allocationCount() - allocations;
+    THEN("The cloud value is saved, read and applied without a String") {
+      REQUIRE(allocated == 0);
+      REQUIRE(text == cloud_text.c_str());
+    }
+  }
+  WHEN("The cloud value is skipped, a local change being pending") {
+    thing.readProperties();
+    text = String(20, 'l').c_str();
+    unsigned long const allocations = allocationCount();
+    thing.readProperties();
+    unsigned long const allocated = allocationCount() - allocations;
+    THEN("The cloud value is restored from the snapshot without a String") {
+      REQUIRE(allocated == 0);
+      REQUIRE(text == String(20, 'l').c_str());
+      REQUIRE(text.isDifferentFromCloud());
+    }
+  }
+}
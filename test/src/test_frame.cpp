@@ -0,0 +1,259 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudFrameLite.h>
+#include <ArduinoCloudPropertyLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+#include <util/TransportSpy.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Values appended to a write frame are decoded back", "[ArduinoCloudFrameLite]") {
+  ArduinoCloudFrameLite frame;
+  frame.beginWrite(NULL);
+
+  WHEN("Entries are keyed by name") {
+    REQUIRE(frame.append("b", 0, true));
+    REQUIRE(frame.append("i", 0, -123456));
+    REQUIRE(frame.append("f", 0, 3.25f));
+    REQUIRE(frame.append("s", 0, String("hello")));
+    REQUIRE(frame.append("t", 0, 42, 1234567890UL));
+
+    THEN("Each entry is parsed with its key, value and timestamp") {
+      REQUIRE(frame.count() == 5);
+      ArduinoCloudFrameLite::Entry entry;
+      size_t offset = 1;
+
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      bool b = false;
+      ArduinoCloudFrameLite::decodeValue(entry.value, b);
+      REQUIRE(entry.key == ArduinoCloudFrameLite::Key::Name);
+      REQUIRE(String(entry.name, entry.name_length) == "b");
+      REQUIRE(entry.type == Type::Bool);
+      REQUIRE(b == true);
+
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      int i = 0;
+      ArduinoCloudFrameLite::decodeValue(entry.value, i);
+      REQUIRE(entry.type == Type::Int);
+      REQUIRE(i == -123456);
+
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      float f = 0.0f;
+      ArduinoCloudFrameLite::decodeValue(entry.value, f);
+      REQUIRE(entry.type == Type::Float);
+      REQUIRE(f == 3.25f);
+
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      String s;
+      ArduinoCloudFrameLite::decodeValue(entry.value, s);
+      REQUIRE(entry.type == Type::String);
+      REQUIRE(s == "hello");
+      REQUIRE(entry.timestamp == 0);
+
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      REQUIRE(entry.timestamp == 1234567890UL);
+
+      REQUIRE(offset == frame.length());
+      REQUIRE_FALSE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+    }
+  }
+
+  WHEN("The light payload is enabled") {
+    frame.setLightPayload(true);
+    REQUIRE(frame.append("a_long_property_name", 0x0203, 7));
+
+    THEN("The entry is keyed by its 16 bit identifier") {
+      /* count, tag, identifier, int32 */
+      REQUIRE(frame.length() == 1 + 1 + 2 + 4);
+      ArduinoCloudFrameLite::Entry entry;
+      size_t offset = 1;
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      REQUIRE(entry.key == ArduinoCloudFrameLite::Key::Identifier);
+      REQUIRE(entry.name == NULL);
+      REQUIRE(entry.identifier == 0x0203);
+    }
+  }
+}
+
+SCENARIO("Malformed frames are rejected by parseEntry()", "[ArduinoCloudFrameLite]") {
+  ArduinoCloudFrameLite frame;
+  frame.beginWrite(NULL);
+  REQUIRE(frame.append("temperature", 0, 3.5f));
+
+  ArduinoCloudFrameLite::Entry entry;
+  for (size_t length = 1; length < frame.length(); length++) {
+    size_t offset = 1;
+    REQUIRE_FALSE(ArduinoCloudFrameLite::parseEntry(frame.data(), length, offset, ArduinoCloudFrameLite::Mode::Write, entry));
+    REQUIRE(offset == 1);
+  }
+}
+
+SCENARIO("A write frame without transport is a bounded store", "[ArduinoCloudFrameLite]") {
+  ArduinoCloudFrameLite frame;
+  frame.beginWrite(NULL);
+
+  int appended = 0;
+  while (frame.append("value", 0, appended)) {
+    appended++;
+  }
+
+  REQUIRE(appended == frame.count());
+  REQUIRE(frame.length() <= frame.capacity());
+  /* count, tag, name length, "value", int32 */
+  REQUIRE(appended == static_cast<int>((frame.capacity() - 1) / (1 + 1 + 5 + 4)));
+
+  WHEN("An entry is removed") {
+    ArduinoCloudFrameLite::Entry entry;
+    size_t offset = 1;
+    REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+    frame.remove(1, offset - 1);
+
+    THEN("The next one becomes the first one") {
+      REQUIRE(frame.count() == appended - 1);
+      offset = 1;
+      REQUIRE(ArduinoCloudFrameLite::parseEntry(frame.data(), frame.length(), offset, ArduinoCloudFrameLite::Mode::Write, entry));
+      int value = -1;
+      ArduinoCloudFrameLite::decodeValue(entry.value, value);
+      REQUIRE(value == 1);
+      REQUIRE(frame.append("value", 0, appended));
+    }
+  }
+}
+
+SCENARIO("A write frame with transport is flushed whenever it is full", "[ArduinoCloudFrameLite]") {
+  TransportSpy spy;
+  ArduinoCloudFrameLite frame;
+  frame.beginWrite(&spy);
+
+  for (int i = 0; i < 100; i++) {
+    frame.iotWritePropertyInt("value", 0, i);
+  }
+  frame.end();
+
+  THEN("Every value reaches the transport once, in order, in as few frames as possible") {
+    REQUIRE(spy.writes.size() == 100);
+    for (int i = 0; i < 100; i++) {
+      REQUIRE(spy.writes[i].int_value == i);
+      REQUIRE(spy.writes[i].frame >= 0);
+    }
+    int const per_frame = (frame.capacity() - 1) / (1 + 1 + 5 + 4);
+    REQUIRE(spy.frames == (100 + per_frame - 1) / per_frame);
+    REQUIRE(frame.flushes() == spy.frames);
+  }
+}
+
+SCENARIO("The entries of a group are flushed together", "[ArduinoCloudFrameLite]") {
+  TransportSpy spy;
+  ArduinoCloudFrameLite frame;
+  frame.beginWrite(&spy);
+
+  /* Fill the frame up to a few bytes of its end, then append a group of 3 entries which does not fit the rest */
+  int filler = 0;
+  while ((frame.length() + 3 * (1 + 1 + 5 + 4)) <= frame.capacity()) {
+    frame.iotWritePropertyInt("value", 0, filler++);
+  }
+  frame.beginGroup();
+  frame.iotWritePropertyInt("attr1", 0, 1);
+  frame.iotWritePropertyInt("attr2", 0, 2);
+  frame.iotWritePropertyInt("attr3", 0, 3);
+  frame.endGroup();
+  frame.end();
+
+  THEN("The entries preceding the group are flushed on their own") {
+    REQUIRE(spy.frames == 2);
+    REQUIRE(spy.writes.size() == static_cast<size_t>(filler + 3));
+    REQUIRE(spy.writes[filler - 1].frame == 0);
+    REQUIRE(spy.writes[filler].frame == 1);
+    REQUIRE(spy.writes[filler + 1].frame == 1);
+    REQUIRE(spy.writes[filler + 2].frame == 1);
+  }
+}
+
+SCENARIO("A query frame is answered by a response frame", "[ArduinoCloudFrameLite]") {
+  ArduinoCloudTransportLoopback loopback;
+  REQUIRE(loopback.setCloudValue("switch", 1, true, 10));
+  REQUIRE(loopback.setCloudValue("counter", 2, 1000, 20));
+  REQUIRE(loopback.setCloudValue("label", 3, String("on"), 30));
+
+  ArduinoCloudFrameLite query;
+  query.beginQuery(loopback);
+  bool b = false;
+  int i = 0;
+  float f = 0.0f;
+  String s;
+  unsigned long timestamp = 0;
+  query.iotReadPropertyBool("switch", 1, b, timestamp);
+  query.iotReadPropertyInt("counter", 2, i, timestamp);
+  query.iotReadPropertyFloat("unknown", 4, f, timestamp);
+  query.iotReadPropertyString("label", 3, s, timestamp);
+  REQUIRE(query.count() == 4);
+  REQUIRE_FALSE(query.overflowed());
+
+  ArduinoCloudFrameLite response;
+  size_t const length = loopback.iotReadProperties(query.data(), query.length(), response.responseBuffer(), response.capacity());
+  response.beginResponse(NULL, length);
+
+  THEN("Known values are read back with their timestamp, unknown ones are missing") {
+    REQUIRE(response.count() == 3);
+    REQUIRE(response.read("label", 3, s, &timestamp));
+    REQUIRE(s == "on");
+    REQUIRE(timestamp == 30);
+    REQUIRE(response.read("switch", 1, b, &timestamp));
+    REQUIRE(b == true);
+    REQUIRE(timestamp == 10);
+    REQUIRE(response.read("counter", 2, i, &timestamp));
+    REQUIRE(i == 1000);
+    REQUIRE(timestamp == 20);
+    REQUIRE_FALSE(response.read("unknown", 4, f, &timestamp));
+    /* Same key, other type */
+    REQUIRE_FALSE(response.read("counter", 2, f, &timestamp));
+  }
+}
+
+SCENARIO("A query frame reports when it is full", "[ArduinoCloudFrameLite]") {
+  TransportSpy spy;
+  ArduinoCloudFrameLite query;
+  query.beginQuery(spy);
+
+  int listed = 0;
+  int value = 0;
+  unsigned long timestamp = 0;
+  while (!query.overflowed()) {
+    query.checkpoint();
+    query.iotReadPropertyInt("value", 0, value, timestamp);
+    listed++;
+  }
+  query.rollback();
+
+  THEN("The response expected for the listed entries fits a frame") {
+    REQUIRE(query.count() == listed - 1);
+    /* count + entries of tag, name length, "value", int32, timestamp */
+    REQUIRE((1 + query.count() * (1 + 1 + 5 + 4 + 4)) <= static_cast<int>(query.capacity()));
+    REQUIRE_FALSE(query.overflowed());
+  }
+}
@@ -0,0 +1,310 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudOfflineQueueLite.h>
+#include <ArduinoCloudStaticThingLite.h>
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+#include <util/TransportSpy.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Values written to the offline queue are kept with their timestamp", "[ArduinoCloudOfflineQueueLite]") {
+  ArduinoCloudOfflineQueueLite queue;
+  REQUIRE(queue.isEmpty());
+
+  queue.setTimestamp(100);
+  queue.iotWritePropertyInt("counter", 1, 10);
+  queue.setTimestamp(200);
+  queue.iotWritePropertyFloat("temperature", 2, 21.5f);
+  queue.setTimestamp(300);
+  queue.iotWritePropertyString("label", 3, String("idle"));
+  REQUIRE(queue.count() == 3);
+
+  WHEN("They are drained into a frame") {
+    TransportSpy spy;
+    spy.setFramesSupported(true);
+    ArduinoCloudFrameLite frame;
+    frame.beginWrite(&spy);
+    queue.drain(spy, &frame);
+    frame.end();
+
+    THEN("They leave oldest first in a single frame, each with its timestamp") {
+      REQUIRE(queue.isEmpty());
+      REQUIRE(spy.frames == 1);
+      REQUIRE(spy.writes.size() == 3);
+      REQUIRE(spy.writes[0].name == "counter");
+      REQUIRE(spy.writes[0].int_value == 10);
+      REQUIRE(spy.writes[0].timestamped);
+      REQUIRE(spy.writes[0].timestamp == 100);
+      REQUIRE(spy.writes[1].name == "temperature");
+      REQUIRE(spy.writes[1].float_value == 21.5f);
+      REQUIRE(spy.writes[1].timestamp == 200);
+      REQUIRE(spy.writes[2].name == "label");
+      REQUIRE(spy.writes[2].string_value == "idle");
+      REQUIRE(spy.writes[2].timestamp == 300);
+    }
+  }
+}
+
+SCENARIO("Values drained without a frame keep their timestamp", "[ArduinoCloudOfflineQueueLite]") {
+  ArduinoCloudOfflineQueueLite queue;
+  for (int i = 0; i < 5; i++) {
+    queue.setTimestamp(1000 + i);
+    queue.iotWritePropertyInt("counter", 1, i);
+  }
+
+  WHEN("The link holds") {
+    TransportSpy spy;
+    queue.drain(spy, NULL);
+    THEN("Each value is sent on its own with its timestamp") {
+      REQUIRE(queue.isEmpty());
+      REQUIRE(spy.frames == 0);
+      REQUIRE(spy.writes.size() == 5);
+      for (int i = 0; i < 5; i++) {
+        REQUIRE(spy.writes[i].int_value == i);
+        REQUIRE(spy.writes[i].timestamped);
+        REQUIRE(spy.writes[i].timestamp == static_cast<unsigned long>(1000 + i));
+      }
+    }
+  }
+  WHEN("The link drops while a value is sent") {
+    TransportSpy spy;
+    spy.disconnectAfter(2);
+    queue.drain(spy, NULL);
+    THEN("The link is checked once they have all been sent, and they all stay queued") {
+      REQUIRE(spy.writes.size() == 5);
+      REQUIRE(queue.count() == 5);
+
+      spy.setConnected(true);
+      spy.writes.clear();
+      queue.drain(spy, NULL);
+      REQUIRE(queue.isEmpty());
+      REQUIRE(spy.writes.size() == 5);
+      REQUIRE(spy.writes[0].int_value == 0);
+      REQUIRE(spy.writes[0].timestamp == 1000);
+      REQUIRE(spy.writes[4].int_value == 4);
+    }
+  }
+}
+
+SCENARIO("A full offline queue makes room according to its policy", "[ArduinoCloudOfflineQueueLite]") {
+  ArduinoCloudOfflineQueueLite queue;
+
+  /* Fill the queue with values of "a", then "b" as the newest one */
+  int values = 0;
+  while (queue.dropped() == 0) {
+    queue.iotWritePropertyInt("a", 0, values++);
+  }
+  int const capacity = queue.count();
+  REQUIRE(capacity == values - 1);
+
+  WHEN("The policy is DropOldest") {
+    queue.setPolicy(OfflinePolicy::DropOldest);
+    queue.iotWritePropertyInt("b", 0, 1000);
+    THEN("The oldest value is dropped") {
+      REQUIRE(queue.count() == capacity);
+      REQUIRE(queue.dropped() == 2);
+
+      TransportSpy spy;
+      queue.drain(spy, NULL);
+      REQUIRE(spy.writes.size() == static_cast<size_t>(capacity));
+      REQUIRE(spy.writes.front().int_value == 2);
+      REQUIRE(spy.writes.back().name == "b");
+    }
+  }
+  WHEN("The policy is KeepLatest") {
+    queue.setPolicy(OfflinePolicy::KeepLatest);
+    queue.iotWritePropertyInt("a", 0, 1000);
+    queue.iotWritePropertyInt("b", 0, 2000);
+    queue.iotWritePropertyInt("b", 0, 3000);
+    THEN("An older value of the same property is dropped, the last value of each property is kept") {
+      TransportSpy spy;
+      queue.drain(spy, NULL);
+      REQUIRE(spy.writes.size() == static_cast<size_t>(capacity));
+      REQUIRE(spy.writes[spy.writes.size() - 2].int_value == 1000);
+      REQUIRE(spy.writes.back().int_value == 3000);
+      for (size_t i = 0; i < spy.writes.size() - 1; i++) {
+        REQUIRE(spy.writes[i].name == "a");
+      }
+    }
+  }
+}
+
+SCENARIO("A Thing queues its updates while disconnected and sends them first once connected", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt counter;
+  counter = 0;
+  thing.addPropertyReal(counter, "counter", Permission::ReadWrite);
+  thing.writeProperties();
+
+  loopback.setConnected(false);
+  loopback.resetCounters();
+  for (int i = 1; i <= 3; i++) {
+    counter = i;
+    thing.writeProperties();
+  }
+
+  THEN("Nothing is sent while disconnected") {
+    REQUIRE(loopback.calls() == 0);
+    REQUIRE(thing.offlineQueueLength() == 3);
+    int cloud = -1;
+    REQUIRE(loopback.getCloudValue("counter", 0, cloud));
+    REQUIRE(cloud == 0);
+  }
+
+  WHEN("The link is back") {
+    loopback.setConnected(true);
+    thing.writeProperties();
+    THEN("The queued updates are sent in a single frame") {
+      REQUIRE(thing.offlineQueueLength() == 0);
+      REQUIRE(loopback.calls() == 1);
+      int cloud = -1;
+      REQUIRE(loopback.getCloudValue("counter", 0, cloud));
+      REQUIRE(cloud == 3);
+    }
+  }
+}
+
+SCENARIO("Without frames, a Thing sends its queued updates first, then the due properties", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  TransportSpy spy;
+  ArduinoCloudThingLite thing(spy);
+  thing.begin();
+
+  CloudInt a, b;
+  a = 0;
+  b = 0;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.writeProperties();
+
+  spy.setConnected(false);
+  a = 1;
+  a = 2;
+  thing.writeProperties();
+  a = 3;
+  thing.writeProperties();
+  REQUIRE(thing.offlineQueueLength() == 2);
+
+  spy.setConnected(true);
+  spy.writes.clear();
+  b = 4;
+  int steps = 0;
+  thing.beginWriteProperties();
+  do {
+    steps++;
+  } while (thing.poll());
+
+  THEN("The queue is drained in one step, each due property in one more") {
+    REQUIRE(thing.offlineQueueLength() == 0);
+    REQUIRE(steps == 2);
+    REQUIRE(spy.writes.size() == 3);
+    REQUIRE(spy.writes[0].name == "a");
+    REQUIRE(spy.writes[0].int_value == 2);
+    REQUIRE(spy.writes[0].timestamped);
+    REQUIRE(spy.writes[1].int_value == 3);
+    REQUIRE(spy.writes[2].name == "b");
+    REQUIRE(spy.writes[2].int_value == 4);
+    REQUIRE_FALSE(spy.writes[2].timestamped);
+  }
+}
+
+SCENARIO("The last value of each property reaches the cloud once connected, although the offline queue overflowed", "[ArduinoCloudThingLite]") {
+  static int const COUNT = 24;
+  static char names[COUNT][16];
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt values[COUNT];
+  for (int i = 0; i < COUNT; i++) {
+    snprintf(names[i], sizeof(names[i]), "property_%02d", i);
+    values[i] = 0;
+    thing.addPropertyReal(values[i], names[i], Permission::ReadWrite);
+  }
+  thing.writeProperties();
+  loopback.setConnected(false);
+
+  WHEN("The oldest values are dropped") {
+    thing.setOfflinePolicy(OfflinePolicy::DropOldest);
+  }
+  WHEN("The older values of the same property are dropped first") {
+    thing.setOfflinePolicy(OfflinePolicy::KeepLatest);
+  }
+
+  for (int round = 1; round <= 2; round++) {
+    for (int i = 0; i < COUNT; i++) {
+      values[i] = round * 100 + i;
+    }
+    thing.writeProperties();
+  }
+  REQUIRE(thing.droppedOfflineUpdates() > 0);
+
+  loopback.setConnected(true);
+  thing.writeProperties();
+  REQUIRE(thing.offlineQueueLength() == 0);
+  for (int i = 0; i < COUNT; i++) {
+    int cloud = -1;
+    REQUIRE(loopback.getCloudValue(names[i], 0, cloud));
+    REQUIRE(cloud == 200 + i);
+  }
+}
+
+SCENARIO("A static Thing publishes again a value dropped from the offline queue", "[ArduinoCloudStaticThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  CloudString a, b, c;
+  ArduinoCloudStaticThingLite<CloudString, CloudString, CloudString> thing(loopback, a, b, c);
+  thing.begin();
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.addPropertyReal(c, "c", Permission::ReadWrite);
+  thing.writeProperties();
+
+  loopback.setConnected(false);
+  a = String(100, 'a');
+  b = String(100, 'b');
+  c = String(100, 'c');
+  thing.writeProperties();
+  REQUIRE(thing.droppedOfflineUpdates() > 0);
+
+  loopback.setConnected(true);
+  thing.writeProperties();
+  String cloud;
+  REQUIRE(loopback.getCloudValue("a", 0, cloud));
+  REQUIRE(cloud == String(100, 'a'));
+  REQUIRE(loopback.getCloudValue("b", 0, cloud));
+  REQUIRE(cloud == String(100, 'b'));
+  REQUIRE(loopback.getCloudValue("c", 0, cloud));
+  REQUIRE(cloud == String(100, 'c'));
+}
@@ -0,0 +1,292 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include <ArduinoCloudPropertyRegistry.h>
+#include <ArduinoCloudStaticThingLite.h>
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+#include <types/CloudColor.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Properties are found by name and by identifier", "[ArduinoCloudPropertyRegistry]") {
+  std::vector<String> names;
+  for (int i = 0; i < 64; i++) {
+    names.push_back("property" + std::to_string(i));
+  }
+  CloudInt properties[64];
+  ArduinoCloudPropertyRegistry<64> registry;
+  for (int i = 0; i < 64; i++) {
+    properties[i].init(names[i].c_str(), Permission::ReadWrite);
+    properties[i].setIdentifier(i + 1);
+    REQUIRE(registry.add(&properties[i]));
+  }
+
+  THEN("Each property is found in its slot") {
+    REQUIRE(registry.isFull());
+    REQUIRE(registry.size() == 64);
+    for (int i = 0; i < 64; i++) {
+      REQUIRE(registry.get(i) == &properties[i]);
+      REQUIRE(registry.find(names[i].c_str()) == &properties[i]);
+      REQUIRE(registry.findByIdentifier(i + 1) == &properties[i]);
+    }
+  }
+  THEN("Unknown names and identifiers are not found") {
+    REQUIRE(registry.find("property64") == NULL);
+    REQUIRE(registry.find("") == NULL);
+    REQUIRE(registry.findByIdentifier(0) == NULL);
+    REQUIRE(registry.findByIdentifier(65) == NULL);
+    REQUIRE(registry.findByIdentifier(-1) == NULL);
+    REQUIRE(registry.findByIdentifier(ArduinoCloudPropertyRegistry<64>::IDENTIFIER_INDEX_SIZE) == NULL);
+  }
+  THEN("A full registry refuses new properties") {
+    CloudInt extra;
+    extra.init("extra", Permission::ReadWrite);
+    REQUIRE_FALSE(registry.add(&extra));
+    REQUIRE(registry.find("extra") == NULL);
+  }
+}
+
+SCENARIO("The first property registered with an identifier wins", "[ArduinoCloudPropertyRegistry]") {
+  CloudInt first, second;
+  first.init("first", Permission::ReadWrite);
+  first.setIdentifier(7);
+  second.init("second", Permission::ReadWrite);
+  second.setIdentifier(7);
+
+  ArduinoCloudPropertyRegistry<4> registry;
+  REQUIRE(registry.add(&first));
+  REQUIRE(registry.add(&second));
+
+  REQUIRE(registry.findByIdentifier(7) == &first);
+  REQUIRE(registry.find("second") == &second);
+}
+
+SCENARIO("A Thing registers each property once, up to its capacity", "[ArduinoCloudThingLite]") {
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  int const count = ARDUINO_CLOUD_THING_LITE_DEFAULT_CAPACITY + 2;
+  std::vector<String> names;
+  for (int i = 0; i < count; i++) {
+    names.push_back("property" + std::to_string(i));
+  }
+  std::vector<CloudInt> properties(count);
+  for (int i = 0; i < count; i++) {
+    properties[i] = i;
+    thing.addPropertyReal(properties[i], names[i].c_str(), Permission::ReadWrite);
+  }
+
+  WHEN("A name is registered again") {
+    CloudInt duplicate;
+    ArduinoCloudPropertyLite & registered = thing.addPropertyReal(duplicate, "property0", Permission::ReadWrite);
+    THEN("The property already registered is returned") {
+      REQUIRE(&registered == &properties[0]);
+    }
+  }
+  THEN("The properties past the capacity are dropped") {
+    REQUIRE(thing.droppedProperties() == 2);
+    REQUIRE(thing.isPropertyInContainer(names[count - 3].c_str()));
+    REQUIRE_FALSE(thing.isPropertyInContainer(names[count - 1].c_str()));
+  }
+  THEN("Identifiers are assigned in registration order, from 1") {
+    REQUIRE(thing.getPropertyByIdentifier(1) == &properties[0]);
+    REQUIRE(String(thing.getPropertyNameByIdentifier(5)) == "property4");
+    /* The upper byte addresses an attribute */
+    REQUIRE(thing.getPropertyByIdentifier((2 << 8) | 5) == &properties[4]);
+    REQUIRE(thing.getPropertyNameByIdentifier(0) == NULL);
+  }
+  THEN("Only the registered properties are published") {
+    thing.writeProperties();
+    int value = -1;
+    REQUIRE(loopback.getCloudValue("property1", 0, value));
+    REQUIRE(value == 1);
+    REQUIRE_FALSE(loopback.getCloudValue(names[count - 1].c_str(), 0, value));
+  }
+}
+
+SCENARIO("A sized Thing holds as many properties as its capacity", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudSizedThingLite<150> thing(loopback);
+  thing.begin();
+
+  int const count = 150;
+  std::vector<String> names;
+  for (int i = 0; i < count; i++) {
+    names.push_back("property" + std::to_string(i));
+  }
+  std::vector<CloudInt> properties(count);
+  for (int i = 0; i < count; i++) {
+    properties[i] = i;
+    thing.addPropertyReal(properties[i], names[i].c_str(), Permission::ReadWrite);
+  }
+  properties[count - 1].publishEvery(10);
+  thing.writeProperties();
+
+  THEN("Every property is registered and published") {
+    REQUIRE(thing.droppedProperties() == 0);
+    REQUIRE(thing.getPropertyByIdentifier(count) == &properties[count - 1]);
+    int value = -1;
+    REQUIRE(loopback.getCloudValue(names[count - 1].c_str(), 0, value));
+    REQUIRE(value == count - 1);
+  }
+  WHEN("One more property is added") {
+    CloudInt extra;
+    thing.addPropertyReal(extra, "extra", Permission::ReadWrite);
+    THEN("It is dropped") {
+      REQUIRE(thing.droppedProperties() == 1);
+      REQUIRE_FALSE(thing.isPropertyInContainer("extra"));
+    }
+  }
+  WHEN("The properties in the last slots change or become due") {
+    properties[count - 2] = 1000;
+    properties[count - 1] = 2000;
+    loopback.resetCounters();
+    thing.writeProperties();
+    int value = -1;
+    THEN("The change is published, the property published at an interval waits for its deadline") {
+      REQUIRE(loopback.getCloudValue(names[count - 2].c_str(), 0, value));
+      REQUIRE(value == 1000);
+      REQUIRE(loopback.getCloudValue(names[count - 1].c_str(), 0, value));
+      REQUIRE(value == count - 1);
+      REQUIRE(thing.nextDeadlineMillis() == 10000);
+    }
+    setMicros(10000000);
+    thing.writeProperties();
+    THEN("It is published once due") {
+      REQUIRE(loopback.getCloudValue(names[count - 1].c_str(), 0, value));
+      REQUIRE(value == 2000);
+    }
+  }
+}
+
+SCENARIO("A composite property whose complete names do not fit is refused", "[ArduinoCloudThingLite]") {
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  /* "name:hue" is one character too long for ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH with the '\0' */
+  String const too_long(ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH - 4, 'c');
+  String const longest(ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH - 5, 'c');
+  CloudColor refused, accepted;
+  refused = Color(10.0f, 20.0f, 30.0f);
+  accepted = Color(40.0f, 50.0f, 60.0f);
+  thing.addPropertyReal(refused, too_long.c_str(), Permission::ReadWrite);
+  thing.addPropertyReal(accepted, longest.c_str(), Permission::ReadWrite);
+
+  REQUIRE(thing.droppedProperties() == 1);
+  REQUIRE_FALSE(thing.isPropertyInContainer(too_long.c_str()));
+  REQUIRE(thing.isPropertyInContainer(longest.c_str()));
+  REQUIRE_FALSE(refused.completeNamesFit());
+
+  WHEN("The refused property is written anyway") {
+    loopback.resetCounters();
+    refused.iotWritePropertyToCloud(loopback);
+    THEN("Its values are not sent under a truncated name") {
+      REQUIRE(loopback.calls() == 0);
+    }
+  }
+  WHEN("The Thing publishes") {
+    thing.writeProperties();
+    THEN("Only the property that fits is sent, under its complete names") {
+      float hue = 0.0f;
+      REQUIRE(loopback.getCloudValue((longest + ":hue").c_str(), 0, hue));
+      REQUIRE(hue == 40.0f);
+    }
+  }
+}
+
+SCENARIO("A static Thing refuses a composite property whose complete names do not fit", "[ArduinoCloudStaticThingLite]") {
+  ArduinoCloudTransportLoopback loopback;
+  CloudColor color;
+  ArduinoCloudStaticThingLite<CloudColor> thing(loopback, color);
+  String const too_long(ARDUINO_CLOUD_PROPERTY_LITE_MAX_NAME_LENGTH - 4, 'c');
+  thing.addPropertyReal(color, too_long.c_str(), Permission::ReadWrite);
+  REQUIRE(thing.droppedProperties() == 1);
+}
+
+SCENARIO("A Thing refuses identifiers out of range or already in use", "[ArduinoCloudThingLite]") {
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt first, explicit_duplicate, out_of_range, negative, second, assigned_duplicate;
+  thing.addPropertyReal(first, "first", Permission::ReadWrite);
+  REQUIRE(first.identifier() == 1);
+
+  WHEN("An explicit identifier is the one assigned to a property already added") {
+    thing.addPropertyReal(explicit_duplicate, "explicit_duplicate", Permission::ReadWrite, 1);
+    THEN("The property is dropped and the first one keeps its identifier") {
+      REQUIRE(thing.droppedProperties() == 1);
+      REQUIRE_FALSE(thing.isPropertyInContainer("explicit_duplicate"));
+      REQUIRE(thing.getPropertyByIdentifier(1) == &first);
+    }
+  }
+  WHEN("An explicit identifier does not fit 8 bits") {
+    thing.addPropertyReal(out_of_range, "out_of_range", Permission::ReadWrite, 256 + 1);
+    thing.addPropertyReal(negative, "negative", Permission::ReadWrite, -2);
+    THEN("The properties are dropped instead of aliasing another one") {
+      REQUIRE(thing.droppedProperties() == 2);
+      REQUIRE_FALSE(thing.isPropertyInContainer("out_of_range"));
+      REQUIRE_FALSE(thing.isPropertyInContainer("negative"));
+      REQUIRE(thing.getPropertyByIdentifier(256 + 1) == &first);
+    }
+  }
+  WHEN("The identifier assigned in registration order is already in use") {
+    /* The third property added would get 3 */
+    thing.addPropertyReal(second, "second", Permission::ReadWrite, 3);
+    thing.addPropertyReal(assigned_duplicate, "assigned_duplicate", Permission::ReadWrite);
+    THEN("The property is dropped") {
+      REQUIRE(thing.droppedProperties() == 1);
+      REQUIRE_FALSE(thing.isPropertyInContainer("assigned_duplicate"));
+      REQUIRE(thing.getPropertyByIdentifier(3) == &second);
+    }
+  }
+  WHEN("The highest identifier is given") {
+    thing.addPropertyReal(second, "second", Permission::ReadWrite, 255);
+    THEN("The property is added") {
+      REQUIRE(thing.droppedProperties() == 0);
+      REQUIRE(thing.getPropertyByIdentifier(255) == &second);
+    }
+  }
+}
+
+SCENARIO("A static Thing refuses identifiers out of range or already in use", "[ArduinoCloudStaticThingLite]") {
+  ArduinoCloudTransportLoopback loopback;
+  CloudInt a, b, c;
+  ArduinoCloudStaticThingLite<CloudInt, CloudInt, CloudInt> thing(loopback, a, b, c);
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  REQUIRE(a.identifier() == 1);
+
+  thing.addPropertyReal(b, "b", Permission::ReadWrite, 1);
+  thing.addPropertyReal(c, "c", Permission::ReadWrite, 256);
+  REQUIRE(thing.droppedProperties() == 2);
+}
@@ -0,0 +1,217 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudPropertyScheduler.h>
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Slots are popped in deadline order once due", "[ArduinoCloudPropertyScheduler]") {
+  ArduinoCloudPropertyScheduler<8> scheduler;
+  REQUIRE(scheduler.isEmpty());
+  REQUIRE(scheduler.popDue(0xFFFFFFFFUL) == -1);
+
+  scheduler.schedule(0, 500);
+  scheduler.schedule(1, 100);
+  scheduler.schedule(2, 300);
+  scheduler.schedule(3, 200);
+  REQUIRE(scheduler.size() == 4);
+  REQUIRE(scheduler.nextDeadline() == 100);
+
+  WHEN("Nothing is due yet") {
+    THEN("Nothing is popped") {
+      REQUIRE(scheduler.popDue(99) == -1);
+      REQUIRE(scheduler.size() == 4);
+    }
+  }
+  WHEN("Several slots are due") {
+    THEN("They are popped earliest first, the others stay") {
+      REQUIRE(scheduler.popDue(300) == 1);
+      REQUIRE(scheduler.popDue(300) == 3);
+      REQUIRE(scheduler.popDue(300) == 2);
+      REQUIRE(scheduler.popDue(300) == -1);
+      REQUIRE(scheduler.size() == 1);
+      REQUIRE(scheduler.nextDeadline() == 500);
+    }
+  }
+  WHEN("A slot is scheduled again") {
+    scheduler.schedule(0, 50);
+    scheduler.schedule(1, 400);
+    THEN("Its deadline is moved instead of added") {
+      REQUIRE(scheduler.size() == 4);
+      REQUIRE(scheduler.popDue(1000) == 0);
+      REQUIRE(scheduler.popDue(1000) == 3);
+      REQUIRE(scheduler.popDue(1000) == 2);
+      REQUIRE(scheduler.popDue(1000) == 1);
+    }
+  }
+  WHEN("A slot is cancelled") {
+    scheduler.cancel(3);
+    scheduler.cancel(3);
+    THEN("It is never popped") {
+      REQUIRE(scheduler.size() == 3);
+      REQUIRE(scheduler.popDue(1000) == 1);
+      REQUIRE(scheduler.popDue(1000) == 2);
+      REQUIRE(scheduler.popDue(1000) == 0);
+      REQUIRE(scheduler.isEmpty());
+    }
+  }
+}
+
+SCENARIO("Deadlines are ordered across the wrap around of the clock", "[ArduinoCloudPropertyScheduler]") {
+  ArduinoCloudPropertyScheduler<4> scheduler;
+  /* unsigned long is the width of the clock, whatever the target */
+  unsigned long const before_wrap = static_cast<unsigned long>(-16);
+  scheduler.schedule(0, before_wrap);
+  scheduler.schedule(1, 16);
+
+  REQUIRE(scheduler.nextDeadline() == before_wrap);
+  REQUIRE(scheduler.popDue(before_wrap + 8) == 0);
+  REQUIRE(scheduler.popDue(before_wrap + 8) == -1);
+  REQUIRE(scheduler.popDue(16) == 1);
+}
+
+SCENARIO("Properties published at a time interval are sent only when due", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt fast, slow;
+  fast = 1;
+  slow = 2;
+  thing.addPropertyReal(fast, "fast", Permission::Read).publishEvery(10 * SECONDS);
+  thing.addPropertyReal(slow, "slow", Permission::Read).publishEvery(30 * SECONDS);
+
+  thing.writeProperties();
+  REQUIRE(loopback.calls() == 2);
+  REQUIRE(thing.nextDeadlineMillis() == 10000);
+
+  WHEN("The interval has not elapsed") {
+    loopback.resetCounters();
+    setMicros(9999UL * 1000);
+    thing.writeProperties();
+    THEN("Nothing is sent, and the properties are not even visited") {
+      REQUIRE(loopback.calls() == 0);
+      REQUIRE(thing.suppressedWrites() == 2);
+      REQUIRE(thing.nextDeadlineMillis() == 1);
+    }
+  }
+  WHEN("The shortest interval has elapsed") {
+    loopback.resetCounters();
+    setMicros(10000UL * 1000);
+    thing.writeProperties();
+    THEN("Only the property it belongs to is sent") {
+      REQUIRE(loopback.calls() == 1);
+      REQUIRE(thing.nextDeadlineMillis() == 10000);
+    }
+  }
+  WHEN("Both intervals have elapsed") {
+    loopback.resetCounters();
+    setMicros(30000UL * 1000);
+    thing.writeProperties();
+    THEN("Both properties are sent") {
+      REQUIRE(loopback.calls() == 2);
+    }
+  }
+}
+
+SCENARIO("A change held back by the minimum time between updates is sent once it has elapsed", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt value;
+  value = 1;
+  thing.addPropertyReal(value, "value", Permission::Read).publishOnChange(0, 5000);
+  thing.writeProperties();
+
+  value = 2;
+  setMicros(1000UL * 1000);
+  thing.writeProperties();
+  int cloud = 0;
+  REQUIRE(loopback.getCloudValue("value", 0, cloud));
+  REQUIRE(cloud == 1);
+  REQUIRE(thing.nextDeadlineMillis() == 4000);
+
+  setMicros(5000UL * 1000);
+  thing.writeProperties();
+  REQUIRE(loopback.getCloudValue("value", 0, cloud));
+  REQUIRE(cloud == 2);
+  REQUIRE(thing.nextDeadlineMillis() == NO_DEADLINE);
+}
+
+SCENARIO("Arithmetic on registered properties leaves them clean", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  CloudInt count;
+  CloudFloat level;
+  count = 10;
+  level = 0.5f;
+  thing.addPropertyReal(count, "count", Permission::ReadWrite);
+  thing.addPropertyReal(level, "level", Permission::ReadWrite);
+  thing.writeProperties();
+  REQUIRE(thing.nextDeadlineMillis() == NO_DEADLINE);
+
+  WHEN("Values are computed from them") {
+    int const sum = count + 5;
+    int const difference = 3 - count;
+    int const shifted = count << 1;
+    float const scaled = level * 4;
+    float const offset = 1.0 + level;
+    THEN("The results are plain values and no property is marked dirty") {
+      REQUIRE(sum == 15);
+      REQUIRE(difference == -7);
+      REQUIRE(shifted == 20);
+      REQUIRE(scaled == 2.0f);
+      REQUIRE(offset == 1.5f);
+      REQUIRE(count == 10);
+      REQUIRE(thing.nextDeadlineMillis() == NO_DEADLINE);
+    }
+  }
+  WHEN("A property is assigned a value computed from another") {
+    CloudInt total;
+    total = 0;
+    thing.addPropertyReal(total, "total", Permission::Read);
+    thing.writeProperties();
+    total = count + count;
+    THEN("Only the assigned property is published") {
+      loopback.resetCounters();
+      thing.writeProperties();
+      REQUIRE(loopback.calls() == 1);
+      int cloud = 0;
+      REQUIRE(loopback.getCloudValue("total", 0, cloud));
+      REQUIRE(cloud == 20);
+    }
+  }
+}
@@ -0,0 +1,164 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportWiFiLite.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The WiFiLite transport follows the status of the module", "[ArduinoCloudTransportWiFiLite]") {
+  WiFiLiteClass wifi;
+  ArduinoCloudTransportWiFiLite transport(wifi);
+
+  wifi.status_code = 3;
+  REQUIRE(transport.isConnected());
+  /* WL_CONNECTION_LOST, WL_DISCONNECTED */
+  wifi.status_code = 5;
+  REQUIRE_FALSE(transport.isConnected());
+  wifi.status_code = 6;
+  REQUIRE_FALSE(transport.isConnected());
+}
+
+SCENARIO("The WiFiLite transport forwards the timestamps the module accepts", "[ArduinoCloudTransportWiFiLite]") {
+  WiFiLiteClass wifi;
+  ArduinoCloudTransportWiFiLite transport(wifi);
+  ArduinoCloudTransportLite & base = transport;
+
+  base.iotWritePropertyInt("counter", 0, 1, 1234);
+  REQUIRE(wifi.calls == 1);
+  REQUIRE(wifi.last_name == "counter");
+  REQUIRE(wifi.last_timestamp == 1234);
+
+  /* The module has no timestamped Float write, the value is sent without it */
+  base.iotWritePropertyFloat("temperature", 0, 1.5f, 5678);
+  REQUIRE(wifi.calls == 2);
+  REQUIRE(wifi.last_name == "temperature");
+  REQUIRE(wifi.last_timestamp == 1234);
+}
+
+SCENARIO("Batched writes stay off while the module does not expose them", "[ArduinoCloudTransportWiFiLite]") {
+  setMicros(0);
+  WiFiLiteClass wifi;
+  ArduinoCloudTransportWiFiLite transport(wifi);
+  REQUIRE_FALSE(transport.supportsFrames());
+
+  ArduinoCloudThingLite thing(transport);
+  thing.begin();
+  CloudInt a, b, c;
+  a = 1;
+  b = 2;
+  c = 3;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.addPropertyReal(c, "c", Permission::ReadWrite);
+  thing.writeProperties();
+
+  REQUIRE(wifi.calls == 3);
+}
+
+SCENARIO("Batched reads stay off while the module does not expose them", "[ArduinoCloudTransportWiFiLite]") {
+  setMicros(0);
+  WiFiLiteClass wifi;
+  ArduinoCloudTransportWiFiLite transport(wifi);
+  REQUIRE_FALSE(transport.supportsQueryFrames());
+  REQUIRE_FALSE(transport.supportsChangeQueries());
+
+  ArduinoCloudThingLite thing(transport);
+  thing.begin();
+  CloudInt a, b;
+  a = 1;
+  b = 2;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.readProperties();
+
+  REQUIRE(wifi.calls == 2);
+}
+
+SCENARIO("A Thing on WiFiLite queues its updates while the module is not connected", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  WiFiLiteClass wifi;
+  ArduinoCloudTransportWiFiLite transport(wifi);
+  ArduinoCloudThingLite thing(transport);
+  thing.begin();
+
+  CloudInt counter;
+  counter = 0;
+  thing.addPropertyReal(counter, "counter", Permission::ReadWrite);
+  thing.writeProperties();
+  REQUIRE(wifi.calls == 1);
+
+  wifi.status_code = 6;
+  counter = 1;
+  thing.writeProperties();
+  thing.readProperties();
+  REQUIRE(wifi.calls == 1);
+  REQUIRE(thing.offlineQueueLength() == 1);
+
+  wifi.status_code = 3;
+  thing.writeProperties();
+  REQUIRE(wifi.calls == 2);
+  REQUIRE(thing.offlineQueueLength() == 0);
+}
+
+SCENARIO("A Thing on WiFiLite reads the status of the module once per cycle", "[ArduinoCloudThingLite]") {
+  setMicros(0);
+  WiFiLiteClass wifi;
+  ArduinoCloudTransportWiFiLite transport(wifi);
+  ArduinoCloudThingLite thing(transport);
+  thing.begin();
+
+  CloudInt a, b, c;
+  a = 0;
+  b = 0;
+  c = 0;
+  thing.addPropertyReal(a, "a", Permission::ReadWrite);
+  thing.addPropertyReal(b, "b", Permission::ReadWrite);
+  thing.addPropertyReal(c, "c", Permission::ReadWrite);
+
+  wifi.status_calls = 0;
+  thing.writeProperties();
+  thing.readProperties();
+  REQUIRE(wifi.calls == 6);
+  REQUIRE(wifi.status_calls == 2);
+
+  WHEN("Queued values are drained one by one") {
+    wifi.status_code = 6;
+    a = 1;
+    b = 1;
+    c = 1;
+    thing.writeProperties();
+    REQUIRE(thing.offlineQueueLength() == 3);
+
+    wifi.status_code = 3;
+    wifi.status_calls = 0;
+    thing.writeProperties();
+    THEN("The status is read once more to tell whether they made it") {
+      REQUIRE(thing.offlineQueueLength() == 0);
+      REQUIRE(wifi.status_calls == 2);
+    }
+  }
+}
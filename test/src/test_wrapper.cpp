@@ -0,0 +1,71 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <catch.hpp>
+
+#include <ArduinoCloudThingLite.h>
+#include <ArduinoCloudTransportLoopback.h>
+#include <types/CloudWrapperString.h>
+
+/******************************************************************************
+   TEST CODE
+ ******************************************************************************/
+
+SCENARIO("A change of a wrapped String is published whatever its content", "[CloudWrapperString]") {
+  setMicros(0);
+  ArduinoCloudTransportLoopback loopback;
+  loopback.setFramesSupported(false);
+  ArduinoCloudThingLite thing(loopback);
+  thing.begin();
+
+  String text("yaczfa");
+  CloudWrapperString wrapper(text);
+  thing.addPropertyReal(wrapper, "text", Permission::Read);
+  thing.writeProperties();
+
+  String cloud;
+  REQUIRE(loopback.getCloudValue("text", 0, cloud));
+  REQUIRE(cloud == "yaczfa");
+
+  WHEN("The String is left unchanged") {
+    loopback.resetCounters();
+    thing.writeProperties();
+    THEN("Nothing is sent") {
+      REQUIRE(loopback.calls() == 0);
+    }
+  }
+  WHEN("The String is changed to another one of the same length and the same FNV-1a hash") {
+    text = "glbppa";
+    thing.writeProperties();
+    THEN("The change is sent") {
+      REQUIRE(loopback.getCloudValue("text", 0, cloud));
+      REQUIRE(cloud == "glbppa");
+    }
+  }
+  WHEN("The String is changed to a longer one") {
+    text += "!";
+    thing.writeProperties();
+    THEN("The change is sent") {
+      REQUIRE(loopback.getCloudValue("text", 0, cloud));
+      REQUIRE(cloud == "yaczfa!");
+    }
+  }
+}
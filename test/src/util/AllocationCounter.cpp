@@ -0,0 +1,68 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <util/AllocationCounter.h>
+
+#include <cstdlib>
+#include <new>
+
+/******************************************************************************
+   GLOBAL VARIABLES
+ ******************************************************************************/
+
+static unsigned long allocations = 0;
+
+/******************************************************************************
+   FUNCTION DEFINITION
+ ******************************************************************************/
+
+unsigned long allocationCount() {
+  return allocations;
+}
+
+void * operator new(std::size_t size) {
+  allocations++;
+  void * p = std::malloc((size != 0) ? size : 1);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void * operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void * p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void * p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void * p, std::size_t /* size */) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void * p, std::size_t /* size */) noexcept {
+  std::free(p);
+}
@@ -0,0 +1,140 @@
+//
+// This file is part of ArduinoCloudThing
+//
+// Copyright 2019 ARDUINO SA (http://www.arduino.cc/)
+//
+// This software is released under the GNU General Public License version 3,
+// which covers the main part of ArduinoCloudThing.
+// The terms of this license can be found at:
+// https://www.gnu.org/licenses/gpl-3.0.en.html
+//
+// You can be released from the requirements of the above licenses by purchasing
+// a commercial license. Buying such a license is mandatory if you want to modify or
+// otherwise use the software for commercial activities involving the Arduino
+// software without disclosing the source code of your own applications. To purchase
+// a commercial license, send an email to license@arduino.cc.
+//
+
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <util/TransportSpy.h>
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+TransportSpy::TransportSpy() :
+  frames(0),
+  reads(0),
+  _frames(false),
+  _connected(true),
+  _disconnect_after(-1)
+{}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void TransportSpy::iotReadPropertyBool(char const * /* name */, uint16_t const /* identifier */, bool & /* value */, unsigned long & /* timestamp */) {
+  reads++;
+}
+
+void TransportSpy::iotReadPropertyInt(char const * /* name */, uint16_t const /* identifier */, int & /* value */, unsigned long & /* timestamp */) {
+  reads++;
+}
+
+void TransportSpy::iotReadPropertyFloat(char const * /* name */, uint16_t const /* identifier */, float & /* value */, unsigned long & /* timestamp */) {
+  reads++;
+}
+
+void TransportSpy::iotReadPropertyString(char const * /* name */, uint16_t const /* identifier */, String & /* value */, unsigned long & /* timestamp */) {
+  reads++;
+}
+
+void TransportSpy::iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value) {
+  record(name, identifier, Type::Bool).bool_value = value;
+}
+
+void TransportSpy::iotWritePropertyInt(char const * name, uint16_t const identifier, int const value) {
+  record(name, identifier, Type::Int).int_value = value;
+}
+
+void TransportSpy::iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value) {
+  record(name, identifier, Type::Float).float_value = value;
+}
+
+void TransportSpy::iotWritePropertyString(char const * name, uint16_t const identifier, String const & value) {
+  record(name, identifier, Type::String).string_value = value;
+}
+
+void TransportSpy::iotWritePropertyBool(char const * name, uint16_t const identifier, bool const value, unsigned long const timestamp) {
+  record(name, identifier, Type::Bool, timestamp).bool_value = value;
+}
+
+void TransportSpy::iotWritePropertyInt(char const * name, uint16_t const identifier, int const value, unsigned long const timestamp) {
+  record(name, identifier, Type::Int, timestamp).int_value = value;
+}
+
+void TransportSpy::iotWritePropertyFloat(char const * name, uint16_t const identifier, float const value, unsigned long const timestamp) {
+  record(name, identifier, Type::Float, timestamp).float_value = value;
+}
+
+void TransportSpy::iotWritePropertyString(char const * name, uint16_t const identifier, String const & value, unsigned long const timestamp) {
+  record(name, identifier, Type::String, timestamp).string_value = value;
+}
+
+void TransportSpy::iotWriteProperties(uint8_t const * frame, size_t const length) {
+  ArduinoCloudFrameLite::Entry entry;
+  size_t offset = 1;
+  for (uint8_t i = 0; i < frame[0]; i++) {
+    size_t const start = offset;
+    if (!ArduinoCloudFrameLite::parseEntry(frame, length, offset, ArduinoCloudFrameLite::Mode::Write, entry)) {
+      break;
+    }
+    String const name = (entry.name != NULL) ? String(entry.name, entry.name_length) : String();
+    Write & write = record(name.c_str(), entry.identifier, entry.type);
+    switch (entry.type) {
+      case Type::Bool:   ArduinoCloudFrameLite::decodeValue(entry.value, write.bool_value);   break;
+      case Type::Int:    ArduinoCloudFrameLite::decodeValue(entry.value, write.int_value);    break;
+      case Type::Float:  ArduinoCloudFrameLite::decodeValue(entry.value, write.float_value);  break;
+      case Type::String: ArduinoCloudFrameLite::decodeValue(entry.value, write.string_value); break;
+    }
+    /* Bit 7 of the tag */
+    write.timestamped = (frame[start] & 0x80) != 0;
+    write.timestamp = entry.timestamp;
+    write.frame = frames;
+  }
+  frames++;
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+TransportSpy::Write & TransportSpy::record(char const * name, uint16_t const identifier, Type const type) {
+  Write write;
+  write.name = name;
+  write.identifier = identifier;
+  write.type = type;
+  write.bool_value = false;
+  write.int_value = 0;
+  write.float_value = 0.0f;
+  write.timestamped = false;
+  write.timestamp = 0;
+  write.frame = -1;
+  writes.push_back(write);
+  if (_disconnect_after > 0 && --_disconnect_after == 0) {
+    _connected = false;
+  }
+  return writes.back();
+}
+
+TransportSpy::Write & TransportSpy::record(char const * name, uint16_t const identifier, Type const type, unsigned long const timestamp) {
+  Write & write = record(name, identifier, type);
+  write.timestamped = true;
+  write.timestamp = timestamp;
+  return write;
+}